@@ -0,0 +1,175 @@
+// MeshOptimizer GDExtension for Godot 4
+// Per-thread scratch arena installed as the meshoptimizer allocator
+
+#include "meshoptimizer_arena.h"
+#include "../thirdparty/meshoptimizer.h"
+
+#include <atomic>
+#include <new>
+
+namespace godot {
+namespace mesh_arena {
+
+namespace {
+
+const size_t ALIGNMENT = 16;
+const size_t MIN_CHUNK_SIZE = 1 << 20;
+const size_t MAX_CHUNK_SIZE = 256 << 20; // Larger requests always go to the heap
+
+std::atomic<bool> installed(false);
+
+std::atomic<uint64_t> arena_allocations(0);
+std::atomic<uint64_t> arena_bytes(0);
+std::atomic<uint64_t> heap_allocations(0);
+std::atomic<uint64_t> heap_bytes(0);
+std::atomic<uint64_t> chunk_allocations(0);
+std::atomic<uint64_t> chunk_bytes(0);
+std::atomic<uint64_t> rewinds(0);
+
+// Chunk memory comes from operator new rather than memalloc: the main thread's arena is
+// released by its thread_local destructor, which runs after the extension is torn down.
+struct Arena {
+    uint8_t *chunk = nullptr;
+    size_t capacity = 0;
+    size_t top = 0;
+    size_t live = 0; // Outstanding arena allocations
+    size_t demand = 0; // Bytes the current cycle would have needed
+
+    ~Arena() { release(); }
+
+    void release() {
+        if (chunk) {
+            ::operator delete(chunk);
+            chunk_bytes -= capacity;
+            chunk = nullptr;
+            capacity = 0;
+        }
+        top = 0;
+        demand = 0;
+    }
+
+    bool owns(const void *ptr) const {
+        const uint8_t *p = static_cast<const uint8_t *>(ptr);
+        return chunk && p >= chunk && p < chunk + capacity;
+    }
+
+    void grow(size_t size) {
+        size_t new_capacity = capacity > 0 ? capacity : MIN_CHUNK_SIZE;
+        while (new_capacity < size && new_capacity < MAX_CHUNK_SIZE) {
+            new_capacity *= 2;
+        }
+        if (new_capacity <= capacity) {
+            return;
+        }
+
+        release();
+        chunk = static_cast<uint8_t *>(::operator new(new_capacity));
+        capacity = new_capacity;
+        chunk_allocations++;
+        chunk_bytes += capacity;
+    }
+
+    void *allocate(size_t size) {
+        size_t aligned = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+
+        if (live == 0) {
+            top = 0;
+            if (demand > capacity || aligned > capacity) {
+                grow(demand > aligned ? demand : aligned);
+            }
+            demand = 0;
+        }
+
+        demand += aligned;
+        if (top + aligned > capacity) {
+            heap_allocations++;
+            heap_bytes += size;
+            return ::operator new(size);
+        }
+
+        void *result = chunk + top;
+        top += aligned;
+        live++;
+        arena_allocations++;
+        arena_bytes += size;
+        return result;
+    }
+
+    void deallocate(void *ptr) {
+        if (!owns(ptr)) {
+            ::operator delete(ptr);
+            return;
+        }
+
+        if (--live == 0) {
+            top = 0;
+            rewinds++;
+        }
+    }
+};
+
+thread_local Arena thread_arena;
+
+void *MESHOPTIMIZER_ALLOC_CALLCONV arena_allocate(size_t size) {
+    return thread_arena.allocate(size);
+}
+
+void MESHOPTIMIZER_ALLOC_CALLCONV arena_deallocate(void *ptr) {
+    thread_arena.deallocate(ptr);
+}
+
+void *MESHOPTIMIZER_ALLOC_CALLCONV heap_allocate(size_t size) {
+    return ::operator new(size);
+}
+
+void MESHOPTIMIZER_ALLOC_CALLCONV heap_deallocate(void *ptr) {
+    ::operator delete(ptr);
+}
+
+} // namespace
+
+void install() {
+    meshopt_setAllocator(arena_allocate, arena_deallocate);
+    installed = true;
+}
+
+void uninstall() {
+    meshopt_setAllocator(heap_allocate, heap_deallocate);
+    installed = false;
+    release_thread_arena();
+}
+
+bool is_installed() {
+    return installed;
+}
+
+Stats get_stats() {
+    Stats stats;
+    stats.arena_allocations = arena_allocations;
+    stats.arena_bytes = arena_bytes;
+    stats.heap_allocations = heap_allocations;
+    stats.heap_bytes = heap_bytes;
+    stats.chunk_allocations = chunk_allocations;
+    stats.chunk_bytes = chunk_bytes;
+    stats.rewinds = rewinds;
+    return stats;
+}
+
+void reset_stats() {
+    // chunk_bytes tracks memory currently held, so it is not a counter to reset
+    arena_allocations = 0;
+    arena_bytes = 0;
+    heap_allocations = 0;
+    heap_bytes = 0;
+    chunk_allocations = 0;
+    rewinds = 0;
+}
+
+void release_thread_arena() {
+    if (thread_arena.live == 0) {
+        thread_arena.release();
+    }
+}
+
+} // namespace mesh_arena
+} // namespace godot
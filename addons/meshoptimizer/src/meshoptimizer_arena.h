@@ -0,0 +1,42 @@
+// MeshOptimizer GDExtension for Godot 4
+// Per-thread scratch arena installed as the meshoptimizer allocator
+#ifndef MESHOPTIMIZER_ARENA_H
+#define MESHOPTIMIZER_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace godot {
+namespace mesh_arena {
+
+// meshoptimizer allocates its scratch (quadrics, hash tables, adjacency) at the start of a
+// call and frees all of it before returning. Each thread bump-allocates from its own chunk
+// and rewinds once everything is freed, so repeated calls on a worker reuse the same memory
+// instead of going through the global heap. Requests that do not fit while the chunk is in
+// use go to the heap, and the chunk grows to the observed peak on the next rewind.
+
+struct Stats {
+    uint64_t arena_allocations = 0;
+    uint64_t arena_bytes = 0;
+    uint64_t heap_allocations = 0; // Fallbacks that did not fit the arena
+    uint64_t heap_bytes = 0;
+    uint64_t chunk_allocations = 0; // Arena chunks (re)allocated from the heap
+    uint64_t chunk_bytes = 0; // Chunk memory currently held across all threads
+    uint64_t rewinds = 0;
+};
+
+// Install/uninstall as the meshoptimizer allocator, done from module (un)initialization
+void install();
+void uninstall();
+bool is_installed();
+
+Stats get_stats();
+void reset_stats();
+
+// Free the calling thread's chunk (it is also freed when the thread exits)
+void release_thread_arena();
+
+} // namespace mesh_arena
+} // namespace godot
+
+#endif // MESHOPTIMIZER_ARENA_H
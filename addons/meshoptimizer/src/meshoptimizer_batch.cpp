@@ -0,0 +1,275 @@
+// MeshOptimizer GDExtension for Godot 4
+// Batch simplification on a native worker pool
+
+#include "meshoptimizer_batch.h"
+
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/core/memory.hpp>
+#include <chrono>
+
+using namespace godot;
+
+namespace {
+
+uint64_t now_usec() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace
+
+void MeshOptimizerBatch::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("queue_simplify", "mesh_arrays", "target_ratio", "target_error", "attribute_weights"),
+        &MeshOptimizerBatch::queue_simplify, DEFVAL(0.01f), DEFVAL(Dictionary()));
+    ClassDB::bind_method(D_METHOD("queue_lod_chain", "mesh_arrays", "ratios", "target_error", "attribute_weights"),
+        &MeshOptimizerBatch::queue_lod_chain, DEFVAL(0.01f), DEFVAL(Dictionary()));
+    ClassDB::bind_method(D_METHOD("queue_merge_cell", "cell", "surfaces", "transforms", "params"),
+        &MeshOptimizerBatch::queue_merge_cell, DEFVAL(Dictionary()));
+    ClassDB::bind_method(D_METHOD("poll_results", "max_results"),
+        &MeshOptimizerBatch::poll_results, DEFVAL(-1));
+    ClassDB::bind_method(D_METHOD("cancel_pending"), &MeshOptimizerBatch::cancel_pending);
+    ClassDB::bind_method(D_METHOD("pause"), &MeshOptimizerBatch::pause);
+    ClassDB::bind_method(D_METHOD("resume"), &MeshOptimizerBatch::resume);
+    ClassDB::bind_method(D_METHOD("is_paused"), &MeshOptimizerBatch::is_paused);
+    ClassDB::bind_method(D_METHOD("wait"), &MeshOptimizerBatch::wait);
+    ClassDB::bind_method(D_METHOD("get_pending_count"), &MeshOptimizerBatch::get_pending_count);
+    ClassDB::bind_method(D_METHOD("get_completed_count"), &MeshOptimizerBatch::get_completed_count);
+    ClassDB::bind_method(D_METHOD("get_progress"), &MeshOptimizerBatch::get_progress);
+    ClassDB::bind_method(D_METHOD("reset_progress"), &MeshOptimizerBatch::reset_progress);
+    ClassDB::bind_method(D_METHOD("set_thread_count", "count"), &MeshOptimizerBatch::set_thread_count);
+    ClassDB::bind_method(D_METHOD("get_thread_count"), &MeshOptimizerBatch::get_thread_count);
+    ClassDB::bind_method(D_METHOD("_emit_batch_completed"), &MeshOptimizerBatch::_emit_batch_completed);
+
+    ADD_SIGNAL(MethodInfo("batch_completed"));
+}
+
+MeshOptimizerBatch::MeshOptimizerBatch() {}
+
+MeshOptimizerBatch::~MeshOptimizerBatch() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        exiting = true;
+        queue.clear();
+    }
+    work_available.notify_all();
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+}
+
+void MeshOptimizerBatch::_ensure_workers() {
+    // Called with mutex held
+    if (!workers.empty()) {
+        return;
+    }
+
+    int count = thread_count;
+    if (count <= 0) {
+        // Leave a core for the main thread
+        count = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+    }
+    if (count < 1) count = 1;
+
+    thread_count = count;
+    workers.reserve(count);
+    for (int i = 0; i < count; i++) {
+        workers.emplace_back(&MeshOptimizerBatch::_worker_loop, this, i);
+    }
+}
+
+void MeshOptimizerBatch::_worker_loop(int thread_index) {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+        work_available.wait(lock, [this] { return exiting || (!paused && !queue.empty()); });
+        if (exiting) {
+            return;
+        }
+
+        Job job = std::move(queue.front());
+        queue.pop_front();
+        running++;
+        lock.unlock();
+
+        uint64_t start = now_usec();
+        Dictionary result;
+        result["job_id"] = job.id;
+        if (job.kind == JOB_MERGE_CELL) {
+            result["cell"] = job.cell;
+            result["surfaces"] = MeshOptimizerGD::merge_surfaces(job.mesh_arrays, job.transforms, job.params);
+        } else if (job.kind == JOB_LOD_CHAIN) {
+            result["lods"] = MeshOptimizerGD::generate_lod_chain(job.mesh_arrays, job.ratios, job.target_error, job.attribute_weights);
+        } else {
+            result["arrays"] = MeshOptimizerGD::simplify_mesh_arrays(job.mesh_arrays, job.target_ratio, job.target_error, job.attribute_weights);
+        }
+        uint64_t end = now_usec();
+        result["time_usec"] = static_cast<int64_t>(end - start);
+        result["wait_usec"] = static_cast<int64_t>(start - job.queued_usec);
+        result["thread"] = thread_index;
+
+        lock.lock();
+        completed.push_back(result);
+        running--;
+        finished_total++;
+
+        if (running == 0 && queue.empty()) {
+            work_finished.notify_all();
+            call_deferred("_emit_batch_completed");
+        } else if (running == 0 && paused) {
+            work_finished.notify_all();
+        }
+    }
+}
+
+int MeshOptimizerBatch::_queue(Job &job) {
+    job.queued_usec = now_usec();
+
+    int id;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        id = next_id++;
+        job.id = id;
+        queued_total++;
+        _ensure_workers();
+        queue.push_back(std::move(job));
+    }
+    work_available.notify_one();
+
+    return id;
+}
+
+void MeshOptimizerBatch::_emit_batch_completed() {
+    emit_signal("batch_completed");
+}
+
+int MeshOptimizerBatch::queue_simplify(const Array &mesh_arrays, float target_ratio, float target_error, const Dictionary &attribute_weights) {
+    Job job;
+    job.kind = JOB_SIMPLIFY;
+    job.mesh_arrays = mesh_arrays.duplicate(); // Shallow, packed arrays inside are copy-on-write
+    job.target_ratio = target_ratio;
+    job.target_error = target_error;
+    job.attribute_weights = attribute_weights.duplicate();
+    return _queue(job);
+}
+
+int MeshOptimizerBatch::queue_lod_chain(const Array &mesh_arrays, const PackedFloat32Array &ratios, float target_error, const Dictionary &attribute_weights) {
+    Job job;
+    job.kind = JOB_LOD_CHAIN;
+    job.mesh_arrays = mesh_arrays.duplicate();
+    job.ratios = ratios;
+    job.target_error = target_error;
+    job.attribute_weights = attribute_weights.duplicate();
+    return _queue(job);
+}
+
+int MeshOptimizerBatch::queue_merge_cell(const Variant &cell, const Array &surfaces, const Array &transforms, const Dictionary &params) {
+    Job job;
+    job.kind = JOB_MERGE_CELL;
+    job.cell = cell;
+    job.mesh_arrays = surfaces.duplicate(); // Outer copy only, each surface Array is shared
+    job.transforms = transforms.duplicate();
+    job.params = params.duplicate();
+    return _queue(job);
+}
+
+Array MeshOptimizerBatch::poll_results(int max_results) {
+    Array result;
+    std::lock_guard<std::mutex> lock(mutex);
+
+    size_t count = completed.size();
+    if (max_results >= 0 && static_cast<size_t>(max_results) < count) {
+        count = static_cast<size_t>(max_results);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        result.push_back(completed[i]);
+    }
+    completed.erase(completed.begin(), completed.begin() + count);
+
+    return result;
+}
+
+int MeshOptimizerBatch::cancel_pending() {
+    int dropped;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        dropped = static_cast<int>(queue.size());
+        cancelled_total += dropped;
+        queue.clear();
+        if (running == 0) {
+            work_finished.notify_all();
+        }
+    }
+    return dropped;
+}
+
+void MeshOptimizerBatch::pause() {
+    std::lock_guard<std::mutex> lock(mutex);
+    paused = true;
+    if (running == 0) {
+        work_finished.notify_all();
+    }
+}
+
+void MeshOptimizerBatch::resume() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        paused = false;
+    }
+    work_available.notify_all();
+}
+
+bool MeshOptimizerBatch::is_paused() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return paused;
+}
+
+void MeshOptimizerBatch::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    work_finished.wait(lock, [this] { return (queue.empty() || paused) && running == 0; });
+}
+
+int MeshOptimizerBatch::get_pending_count() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return static_cast<int>(queue.size()) + running;
+}
+
+int MeshOptimizerBatch::get_completed_count() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return static_cast<int>(completed.size());
+}
+
+Dictionary MeshOptimizerBatch::get_progress() {
+    Dictionary result;
+    std::lock_guard<std::mutex> lock(mutex);
+
+    int active = queued_total - cancelled_total;
+    result["queued"] = queued_total;
+    result["finished"] = finished_total;
+    result["cancelled"] = cancelled_total;
+    result["pending"] = static_cast<int>(queue.size());
+    result["running"] = running;
+    result["paused"] = paused;
+    result["progress"] = active > 0 ? static_cast<float>(finished_total) / active : 1.0f;
+
+    return result;
+}
+
+void MeshOptimizerBatch::reset_progress() {
+    std::lock_guard<std::mutex> lock(mutex);
+    queued_total = static_cast<int>(queue.size()) + running;
+    finished_total = 0;
+    cancelled_total = 0;
+}
+
+void MeshOptimizerBatch::set_thread_count(int count) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (workers.empty()) {
+        thread_count = count;
+    }
+}
+
+int MeshOptimizerBatch::get_thread_count() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return thread_count;
+}
@@ -0,0 +1,124 @@
+// MeshOptimizer GDExtension for Godot 4
+// Batch simplification on a native worker pool
+#ifndef MESHOPTIMIZER_BATCH_H
+#define MESHOPTIMIZER_BATCH_H
+
+#include "meshoptimizer_gdext.h"
+
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/packed_float32_array.hpp>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace godot {
+
+// Queue of surface jobs processed by native worker threads
+// Jobs are queued from any thread, results are drained with poll_results() or the
+// batch_completed signal (emitted deferred, on the main thread) once the queue runs dry.
+// Queued mesh arrays are shallow-copied, so callers may reuse their Array afterwards.
+class MeshOptimizerBatch : public RefCounted {
+    GDCLASS(MeshOptimizerBatch, RefCounted)
+
+    enum JobKind {
+        JOB_SIMPLIFY,
+        JOB_LOD_CHAIN,
+        JOB_MERGE_CELL,
+    };
+
+    struct Job {
+        int id = 0;
+        JobKind kind = JOB_SIMPLIFY;
+        Array mesh_arrays;
+        PackedFloat32Array ratios;
+        Dictionary attribute_weights;
+        Variant cell;
+        Array transforms;
+        Dictionary params;
+        float target_ratio = 1.0f;
+        float target_error = 0.01f;
+        uint64_t queued_usec = 0;
+    };
+
+    std::mutex mutex;
+    std::condition_variable work_available;
+    std::condition_variable work_finished;
+    std::deque<Job> queue;
+    std::vector<Dictionary> completed;
+    std::vector<std::thread> workers;
+    int thread_count = 0;
+    int running = 0;
+    int next_id = 1;
+    int queued_total = 0;
+    int finished_total = 0;
+    int cancelled_total = 0;
+    bool paused = false;
+    bool exiting = false;
+
+    void _ensure_workers();
+    void _worker_loop(int thread_index);
+    int _queue(Job &job);
+    void _emit_batch_completed();
+
+protected:
+    static void _bind_methods();
+
+public:
+    MeshOptimizerBatch();
+    ~MeshOptimizerBatch();
+
+    // Queue a simplify_mesh_arrays job, returns the job id
+    int queue_simplify(const Array &mesh_arrays, float target_ratio, float target_error = 0.01f, const Dictionary &attribute_weights = Dictionary());
+
+    // Queue a generate_lod_chain job, returns the job id
+    int queue_lod_chain(const Array &mesh_arrays, const PackedFloat32Array &ratios, float target_error = 0.01f, const Dictionary &attribute_weights = Dictionary());
+
+    // Queue a merge_surfaces job for one prebake cell, returns the job id
+    // cell is passed through to the result unchanged so the caller can identify it
+    int queue_merge_cell(const Variant &cell, const Array &surfaces, const Array &transforms, const Dictionary &params = Dictionary());
+
+    // Drain finished jobs (max_results < 0 drains all)
+    // Returns: Array of Dictionaries with "job_id", "arrays", "lods" or "cell" and "surfaces",
+    //   "time_usec", "wait_usec" and "thread" (worker index)
+    Array poll_results(int max_results = -1);
+
+    // Drop jobs that have not started yet, returns how many were dropped
+    int cancel_pending();
+
+    // Stop starting queued jobs; running jobs finish normally
+    void pause();
+
+    // Start queued jobs again after pause()
+    void resume();
+    bool is_paused();
+
+    // Block until every queued job has finished, or until the running ones have when paused
+    void wait();
+
+    // Jobs queued or running
+    int get_pending_count();
+
+    // Finished jobs not yet polled
+    int get_completed_count();
+
+    // Returns: Dictionary with "queued", "finished" and "cancelled" totals since the last
+    //   reset_progress(), "pending", "running", "paused" and "progress" (finished / non-cancelled, 0..1)
+    Dictionary get_progress();
+
+    // Restart the totals from the jobs currently queued or running
+    void reset_progress();
+
+    // Worker count, 0 = one per core minus the main thread; only applies before the first job
+    void set_thread_count(int count);
+    int get_thread_count();
+};
+
+} // namespace godot
+
+#endif // MESHOPTIMIZER_BATCH_H
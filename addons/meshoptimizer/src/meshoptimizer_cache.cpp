@@ -0,0 +1,460 @@
+// MeshOptimizer GDExtension for Godot 4
+// Content-hashed result cache for the simplification entry points
+
+#include "meshoptimizer_cache.h"
+#include "../thirdparty/meshoptimizer.h"
+
+#include <godot_cpp/classes/dir_access.hpp>
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/resource.hpp>
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/packed_color_array.hpp>
+#include <godot_cpp/variant/packed_float32_array.hpp>
+#include <godot_cpp/variant/packed_float64_array.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_int64_array.hpp>
+#include <godot_cpp/variant/packed_string_array.hpp>
+#include <godot_cpp/variant/packed_vector2_array.hpp>
+#include <godot_cpp/variant/packed_vector3_array.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+
+#include <atomic>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace godot {
+namespace mesh_cache {
+
+namespace {
+
+// Bump when an entry point's output changes for the same input, so stale files are not reused
+const uint64_t CACHE_VERSION = 2;
+const char *FILE_EXTENSION = ".mocache";
+const uint64_t ENTRY_OVERHEAD = 256; // Bookkeeping and Variant headers per entry, roughly
+
+struct Entry {
+    uint64_t key;
+    Variant value;
+    uint64_t bytes;
+};
+
+std::mutex mutex;
+std::list<Entry> entries; // Most recently used first
+std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+String directory;
+Stats stats;
+std::atomic<uint64_t> temp_counter(0);
+
+// XXH64
+const uint64_t PRIME1 = 0x9E3779B185EBCA87ULL;
+const uint64_t PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+const uint64_t PRIME3 = 0x165667B19E3779F9ULL;
+const uint64_t PRIME4 = 0x85EBCA77C2B2AE63ULL;
+const uint64_t PRIME5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t read64(const uint8_t *p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint32_t read32(const uint8_t *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t xxh_round(uint64_t acc, uint64_t input) {
+    acc += input * PRIME2;
+    acc = rotl(acc, 31);
+    return acc * PRIME1;
+}
+
+inline uint64_t merge_round(uint64_t acc, uint64_t value) {
+    acc ^= xxh_round(0, value);
+    return acc * PRIME1 + PRIME4;
+}
+
+// Chains hash_bytes() calls, each seeded with the hash so far
+struct Hasher {
+    uint64_t value;
+
+    void update(const void *data, size_t size) { value = hash_bytes(data, size, value); }
+
+    template <typename T>
+    void update_value(const T &v) { update(&v, sizeof(v)); }
+};
+
+template <typename T>
+void hash_packed(Hasher &hasher, const Variant &value) {
+    const T array = value;
+    hasher.update_value(static_cast<int64_t>(array.size()));
+    if (array.size() > 0) {
+        hasher.update(array.ptr(), array.size() * sizeof(*array.ptr()));
+    }
+}
+
+template <typename T>
+void hash_math(Hasher &hasher, const Variant &value) {
+    // Raw components rather than the 32-bit Variant::hash(), as for the packed arrays
+    const T math = value;
+    hasher.update_value(math);
+}
+
+// Returns false for arguments with no identity that survives the process (objects that are not
+// saved resources, RIDs, callables), so calls carrying them are not cached
+bool hash_variant(Hasher &hasher, const Variant &value) {
+    Variant::Type type = value.get_type();
+    hasher.update_value(static_cast<int32_t>(type));
+
+    switch (type) {
+        case Variant::NIL:
+            break;
+        case Variant::BOOL:
+            hasher.update_value(static_cast<uint8_t>(bool(value)));
+            break;
+        case Variant::INT:
+            hasher.update_value(int64_t(value));
+            break;
+        case Variant::FLOAT:
+            hasher.update_value(double(value));
+            break;
+        case Variant::STRING:
+        case Variant::STRING_NAME:
+        case Variant::NODE_PATH: {
+            CharString utf8 = String(value).utf8();
+            hasher.update_value(static_cast<int64_t>(utf8.length()));
+            hasher.update(utf8.get_data(), utf8.length());
+        } break;
+        case Variant::OBJECT: {
+            // Resources by path (materials in merge_surfaces params), which is the same next run
+            Object *object = value;
+            if (object == nullptr) {
+                break;
+            }
+            Resource *resource = Object::cast_to<Resource>(object);
+            if (resource == nullptr || resource->get_path().is_empty()) {
+                return false;
+            }
+            CharString utf8 = resource->get_path().utf8();
+            hasher.update_value(static_cast<int64_t>(utf8.length()));
+            hasher.update(utf8.get_data(), utf8.length());
+        } break;
+        case Variant::ARRAY: {
+            const Array array = value;
+            hasher.update_value(static_cast<int64_t>(array.size()));
+            for (int64_t i = 0; i < array.size(); i++) {
+                if (!hash_variant(hasher, array[i])) {
+                    return false;
+                }
+            }
+        } break;
+        case Variant::DICTIONARY: {
+            // Insertion order is part of the key; a reordered but equal Dictionary only misses
+            const Dictionary dictionary = value;
+            const Array keys = dictionary.keys();
+            hasher.update_value(static_cast<int64_t>(keys.size()));
+            for (int64_t i = 0; i < keys.size(); i++) {
+                if (!hash_variant(hasher, keys[i]) || !hash_variant(hasher, dictionary[keys[i]])) {
+                    return false;
+                }
+            }
+        } break;
+        case Variant::VECTOR2: hash_math<Vector2>(hasher, value); break;
+        case Variant::VECTOR2I: hash_math<Vector2i>(hasher, value); break;
+        case Variant::RECT2: hash_math<Rect2>(hasher, value); break;
+        case Variant::RECT2I: hash_math<Rect2i>(hasher, value); break;
+        case Variant::VECTOR3: hash_math<Vector3>(hasher, value); break;
+        case Variant::VECTOR3I: hash_math<Vector3i>(hasher, value); break;
+        case Variant::TRANSFORM2D: hash_math<Transform2D>(hasher, value); break;
+        case Variant::VECTOR4: hash_math<Vector4>(hasher, value); break;
+        case Variant::VECTOR4I: hash_math<Vector4i>(hasher, value); break;
+        case Variant::PLANE: hash_math<Plane>(hasher, value); break;
+        case Variant::QUATERNION: hash_math<Quaternion>(hasher, value); break;
+        case Variant::AABB: hash_math<AABB>(hasher, value); break;
+        case Variant::BASIS: hash_math<Basis>(hasher, value); break;
+        case Variant::TRANSFORM3D: hash_math<Transform3D>(hasher, value); break;
+        case Variant::PROJECTION: hash_math<Projection>(hasher, value); break;
+        case Variant::COLOR: hash_math<Color>(hasher, value); break;
+        case Variant::PACKED_BYTE_ARRAY: hash_packed<PackedByteArray>(hasher, value); break;
+        case Variant::PACKED_INT32_ARRAY: hash_packed<PackedInt32Array>(hasher, value); break;
+        case Variant::PACKED_INT64_ARRAY: hash_packed<PackedInt64Array>(hasher, value); break;
+        case Variant::PACKED_FLOAT32_ARRAY: hash_packed<PackedFloat32Array>(hasher, value); break;
+        case Variant::PACKED_FLOAT64_ARRAY: hash_packed<PackedFloat64Array>(hasher, value); break;
+        case Variant::PACKED_VECTOR2_ARRAY: hash_packed<PackedVector2Array>(hasher, value); break;
+        case Variant::PACKED_VECTOR3_ARRAY: hash_packed<PackedVector3Array>(hasher, value); break;
+        case Variant::PACKED_COLOR_ARRAY: hash_packed<PackedColorArray>(hasher, value); break;
+        case Variant::PACKED_STRING_ARRAY: {
+            const PackedStringArray strings = value;
+            hasher.update_value(static_cast<int64_t>(strings.size()));
+            for (int64_t i = 0; i < strings.size(); i++) {
+                CharString utf8 = strings[i].utf8();
+                hasher.update_value(static_cast<int64_t>(utf8.length()));
+                hasher.update(utf8.get_data(), utf8.length());
+            }
+        } break;
+        default:
+            return false;
+    }
+    return true;
+}
+
+// Whether a result holds objects; var_to_bytes writes those as instance ids, which mean nothing
+// to the next process, so such results stay in memory only
+bool has_objects(const Variant &value) {
+    switch (value.get_type()) {
+        case Variant::OBJECT:
+            return true;
+        case Variant::ARRAY: {
+            const Array array = value;
+            for (int64_t i = 0; i < array.size(); i++) {
+                if (has_objects(array[i])) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        case Variant::DICTIONARY: {
+            const Dictionary dictionary = value;
+            return has_objects(dictionary.keys()) || has_objects(dictionary.values());
+        }
+        default:
+            return false;
+    }
+}
+
+template <typename T>
+uint64_t packed_bytes(const Variant &value) {
+    const T array = value;
+    return static_cast<uint64_t>(array.size()) * sizeof(*array.ptr());
+}
+
+// Memory an entry keeps alive, counting shared packed arrays once per reference
+uint64_t variant_bytes(const Variant &value) {
+    switch (value.get_type()) {
+        case Variant::ARRAY: {
+            const Array array = value;
+            uint64_t bytes = 0;
+            for (int64_t i = 0; i < array.size(); i++) {
+                bytes += variant_bytes(array[i]);
+            }
+            return bytes;
+        }
+        case Variant::DICTIONARY: {
+            const Dictionary dictionary = value;
+            return variant_bytes(dictionary.values());
+        }
+        case Variant::PACKED_BYTE_ARRAY: return packed_bytes<PackedByteArray>(value);
+        case Variant::PACKED_INT32_ARRAY: return packed_bytes<PackedInt32Array>(value);
+        case Variant::PACKED_INT64_ARRAY: return packed_bytes<PackedInt64Array>(value);
+        case Variant::PACKED_FLOAT32_ARRAY: return packed_bytes<PackedFloat32Array>(value);
+        case Variant::PACKED_FLOAT64_ARRAY: return packed_bytes<PackedFloat64Array>(value);
+        case Variant::PACKED_VECTOR2_ARRAY: return packed_bytes<PackedVector2Array>(value);
+        case Variant::PACKED_VECTOR3_ARRAY: return packed_bytes<PackedVector3Array>(value);
+        case Variant::PACKED_COLOR_ARRAY: return packed_bytes<PackedColorArray>(value);
+        default: return sizeof(Variant);
+    }
+}
+
+String entry_path(const String &dir, uint64_t key) {
+    return dir.path_join(String::num_uint64(key, 16).lpad(16, "0") + FILE_EXTENSION);
+}
+
+// Called with mutex held
+void insert(uint64_t key, const Variant &value) {
+    if (stats.max_bytes == 0) {
+        return;
+    }
+
+    uint64_t bytes = variant_bytes(value) + ENTRY_OVERHEAD;
+    if (bytes > stats.max_bytes) {
+        return; // Would evict everything else and still not fit
+    }
+
+    auto it = index.find(key);
+    if (it != index.end()) {
+        stats.bytes -= it->second->bytes;
+        entries.erase(it->second);
+        index.erase(it);
+    }
+
+    entries.push_front({ key, value, bytes });
+    index[key] = entries.begin();
+    stats.bytes += bytes;
+
+    while (stats.bytes > stats.max_bytes && !entries.empty()) {
+        const Entry &oldest = entries.back();
+        stats.bytes -= oldest.bytes;
+        index.erase(oldest.key);
+        entries.pop_back();
+        stats.evictions++;
+    }
+    stats.entries = entries.size();
+}
+
+} // namespace
+
+void configure(uint64_t max_bytes, const String &p_directory) {
+    if (!p_directory.is_empty()) {
+        DirAccess::make_dir_recursive_absolute(p_directory);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    directory = p_directory;
+    stats.max_bytes = max_bytes;
+
+    while (stats.bytes > stats.max_bytes && !entries.empty()) {
+        const Entry &oldest = entries.back();
+        stats.bytes -= oldest.bytes;
+        index.erase(oldest.key);
+        entries.pop_back();
+        stats.evictions++;
+    }
+    stats.entries = entries.size();
+}
+
+bool is_enabled() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats.max_bytes > 0 || !directory.is_empty();
+}
+
+uint64_t hash_bytes(const void *data, size_t size, uint64_t seed) {
+    const uint8_t *p = static_cast<const uint8_t *>(data);
+    const uint8_t *end = p + size;
+    uint64_t h;
+
+    if (size >= 32) {
+        uint64_t v1 = seed + PRIME1 + PRIME2;
+        uint64_t v2 = seed + PRIME2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - PRIME1;
+        for (; p + 32 <= end; p += 32) {
+            v1 = xxh_round(v1, read64(p));
+            v2 = xxh_round(v2, read64(p + 8));
+            v3 = xxh_round(v3, read64(p + 16));
+            v4 = xxh_round(v4, read64(p + 24));
+        }
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        h = merge_round(h, v1);
+        h = merge_round(h, v2);
+        h = merge_round(h, v3);
+        h = merge_round(h, v4);
+    } else {
+        h = seed + PRIME5;
+    }
+
+    h += static_cast<uint64_t>(size);
+
+    for (; p + 8 <= end; p += 8) {
+        h ^= xxh_round(0, read64(p));
+        h = rotl(h, 27) * PRIME1 + PRIME4;
+    }
+    if (p + 4 <= end) {
+        h ^= static_cast<uint64_t>(read32(p)) * PRIME1;
+        h = rotl(h, 23) * PRIME2 + PRIME3;
+        p += 4;
+    }
+    for (; p < end; p++) {
+        h ^= (*p) * PRIME5;
+        h = rotl(h, 11) * PRIME1;
+    }
+
+    h ^= h >> 33;
+    h *= PRIME2;
+    h ^= h >> 29;
+    h *= PRIME3;
+    h ^= h >> 32;
+    return h;
+}
+
+uint64_t hash_call(const char *entry_point, const Variant &arguments) {
+    Hasher hasher{ CACHE_VERSION };
+    hasher.update_value(static_cast<uint64_t>(MESHOPTIMIZER_VERSION));
+    hasher.update(entry_point, strlen(entry_point));
+    if (!hash_variant(hasher, arguments)) {
+        return 0;
+    }
+    // 0 means "not cached" to callers
+    return hasher.value != 0 ? hasher.value : 1;
+}
+
+bool lookup(uint64_t key, Variant &r_value) {
+    String dir;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = index.find(key);
+        if (it != index.end()) {
+            entries.splice(entries.begin(), entries, it->second);
+            r_value = it->second->value.duplicate(true);
+            stats.hits++;
+            return true;
+        }
+        dir = directory;
+    }
+
+    if (!dir.is_empty()) {
+        String path = entry_path(dir, key);
+        if (FileAccess::file_exists(path)) {
+            // No objects are decoded, so a tampered cache file cannot instantiate anything
+            Variant value = UtilityFunctions::bytes_to_var(FileAccess::get_file_as_bytes(path));
+            if (value.get_type() == Variant::ARRAY || value.get_type() == Variant::DICTIONARY) {
+                std::lock_guard<std::mutex> lock(mutex);
+                insert(key, value);
+                stats.hits++;
+                stats.disk_hits++;
+                r_value = value.duplicate(true);
+                return true;
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.misses++;
+    return false;
+}
+
+void store(uint64_t key, const Variant &value) {
+    Variant copy = value.duplicate(true);
+    String dir;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        insert(key, copy);
+        dir = directory;
+    }
+
+    if (!dir.is_empty() && !has_objects(copy)) {
+        // Written beside the final name and renamed, so concurrent readers never see a partial file
+        String path = entry_path(dir, key);
+        String temp_path = path + ".tmp" + String::num_uint64(temp_counter.fetch_add(1));
+        Ref<FileAccess> file = FileAccess::open(temp_path, FileAccess::WRITE);
+        if (file.is_valid()) {
+            file->store_buffer(UtilityFunctions::var_to_bytes(copy));
+            file->close();
+            DirAccess::rename_absolute(temp_path, path);
+        }
+    }
+}
+
+void clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    index.clear();
+    stats.bytes = 0;
+    stats.entries = 0;
+}
+
+Stats get_stats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+} // namespace mesh_cache
+} // namespace godot
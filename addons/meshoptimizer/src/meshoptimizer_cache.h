@@ -0,0 +1,53 @@
+// MeshOptimizer GDExtension for Godot 4
+// Content-hashed result cache for the simplification entry points
+#ifndef MESHOPTIMIZER_CACHE_H
+#define MESHOPTIMIZER_CACHE_H
+
+#include <godot_cpp/variant/string.hpp>
+#include <godot_cpp/variant/variant.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace godot {
+namespace mesh_cache {
+
+// Results are keyed by a 64-bit hash of the entry point name and every argument (array
+// contents included), so an identical surface simplified from another cell or a later prebake
+// run is a lookup. Entries live in an in-memory LRU bounded by their packed array bytes and,
+// when a directory is set, are also written there so they survive restarts.
+// Thread-safe; values are deep-copied in and out, so callers may modify what they get.
+// Results holding objects (merge_surfaces materials) are only kept in memory, where they hold a
+// reference to those objects until evicted or cleared.
+
+struct Stats {
+    uint64_t hits = 0;
+    uint64_t disk_hits = 0; // Also counted in hits
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    uint64_t entries = 0;
+    uint64_t bytes = 0;
+    uint64_t max_bytes = 0;
+};
+
+// max_bytes = 0 disables the memory cache; an empty directory disables the disk cache
+void configure(uint64_t max_bytes, const String &directory);
+bool is_enabled();
+
+uint64_t hash_bytes(const void *data, size_t size, uint64_t seed = 0);
+// 0 when an argument cannot be keyed across runs: objects other than saved resources (hashed
+// by path), RIDs, callables and signals
+uint64_t hash_call(const char *entry_point, const Variant &arguments);
+
+bool lookup(uint64_t key, Variant &r_value);
+void store(uint64_t key, const Variant &value);
+
+// Drop the memory cache (files in the directory are kept)
+void clear();
+
+Stats get_stats();
+
+} // namespace mesh_cache
+} // namespace godot
+
+#endif // MESHOPTIMIZER_CACHE_H
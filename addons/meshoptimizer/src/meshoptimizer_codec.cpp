@@ -0,0 +1,964 @@
+// MeshOptimizer GDExtension for Godot 4
+// Compressed binary container for Godot surfaces (vertex/index codecs)
+
+#include "meshoptimizer_codec.h"
+#include "meshoptimizer_streams.h"
+#include "../thirdparty/meshoptimizer.h"
+
+#include <godot_cpp/classes/mesh.hpp>
+#include <godot_cpp/variant/packed_color_array.hpp>
+#include <godot_cpp/variant/packed_float32_array.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_vector2_array.hpp>
+#include <godot_cpp/variant/packed_vector3_array.hpp>
+#include <cstring>
+#include <vector>
+
+using namespace godot;
+using namespace godot::mesh_streams;
+
+namespace {
+
+using mesh_codec::EncodeOptions;
+
+enum ElementKind : uint8_t {
+    ELEMENT_VECTOR3,
+    ELEMENT_VECTOR2,
+    ELEMENT_COLOR,
+    ELEMENT_FLOAT32,
+    ELEMENT_INT32,
+    ELEMENT_BYTE,
+};
+
+enum StreamFilter : uint8_t {
+    FILTER_NONE,
+    FILTER_OCT,
+    FILTER_EXP,
+};
+
+enum StreamEncoding : uint8_t {
+    ENCODING_RAW,
+    ENCODING_VERTEX_CODEC,
+};
+
+enum IndexEncoding : uint8_t {
+    INDEX_NONE,
+    INDEX_BUFFER_CODEC,
+    INDEX_SEQUENCE_CODEC,
+};
+
+constexpr size_t CONTAINER_HEADER_SIZE = 8;
+constexpr size_t SURFACE_ENTRY_SIZE = 8;
+constexpr size_t SURFACE_HEADER_SIZE = 16;
+constexpr size_t STREAM_RECORD_SIZE = 12;
+constexpr size_t PROGRESSIVE_HEADER_SIZE = 12;
+constexpr size_t PROGRESSIVE_STREAM_SIZE = 8;
+constexpr size_t PROGRESSIVE_LEVEL_SIZE = 16;
+
+// Best case compression, bounding decoded sizes: the vertex codec spends at least 2 header bits
+// on every 16 decoded bytes, the index codecs a byte per triangle (buffer) or index (sequence)
+constexpr uint64_t MAX_VERTEX_EXPANSION = 64;
+constexpr size_t MAX_INDEX_EXPANSION = 3;
+
+struct StreamRecord {
+    uint8_t array_type = 0;
+    uint8_t kind = 0;
+    uint8_t filter = FILTER_NONE;
+    uint8_t encoding = ENCODING_RAW;
+    uint16_t per_vertex = 0; // Elements of kind per vertex
+    uint16_t vertex_size = 0; // Stored bytes per vertex, after filtering
+    uint32_t data_size = 0;
+};
+
+struct Writer {
+    std::vector<uint8_t> bytes;
+
+    void put_u8(uint8_t v) { bytes.push_back(v); }
+    void put_u16(uint16_t v) { put(&v, sizeof(v)); }
+    void put_u32(uint32_t v) { put(&v, sizeof(v)); }
+    void put(const void *data, size_t size) {
+        const uint8_t *p = static_cast<const uint8_t *>(data);
+        bytes.insert(bytes.end(), p, p + size);
+    }
+};
+
+struct Reader {
+    const uint8_t *data;
+    size_t size;
+    size_t offset = 0;
+
+    bool can_read(size_t count) const { return count <= size && offset <= size - count; }
+    uint8_t get_u8() { return data[offset++]; }
+    uint16_t get_u16() { uint16_t v; memcpy(&v, data + offset, sizeof(v)); offset += sizeof(v); return v; }
+    uint32_t get_u32() { uint32_t v; memcpy(&v, data + offset, sizeof(v)); offset += sizeof(v); return v; }
+};
+
+size_t element_size(uint8_t kind) {
+    switch (kind) {
+        case ELEMENT_VECTOR3: return sizeof(float) * 3;
+        case ELEMENT_VECTOR2: return sizeof(float) * 2;
+        case ELEMENT_COLOR: return sizeof(float) * 4;
+        case ELEMENT_FLOAT32: return sizeof(float);
+        case ELEMENT_INT32: return sizeof(int32_t);
+        case ELEMENT_BYTE: return 1;
+        default: return 0;
+    }
+}
+
+bool is_float_kind(uint8_t kind) {
+    return kind == ELEMENT_VECTOR3 || kind == ELEMENT_VECTOR2 || kind == ELEMENT_COLOR || kind == ELEMENT_FLOAT32;
+}
+
+// Canonical little-endian component bytes of one surface array
+// Returns false for arrays that are not per-vertex
+bool stream_bytes(const Variant &value, size_t vertex_count, StreamRecord &r_record, std::vector<uint8_t> &r_bytes) {
+    size_t count = 0;
+    const void *src = nullptr;
+    std::vector<float> scratch;
+
+    switch (value.get_type()) {
+        case Variant::PACKED_VECTOR3_ARRAY: {
+            const PackedVector3Array array = value;
+            count = array.size();
+            src = float_stream(array.ptr(), count, scratch);
+            r_record.kind = ELEMENT_VECTOR3;
+            // Copy out while the array is alive
+            r_bytes.assign(static_cast<const uint8_t *>(src), static_cast<const uint8_t *>(src) + count * element_size(r_record.kind));
+        } break;
+        case Variant::PACKED_VECTOR2_ARRAY: {
+            const PackedVector2Array array = value;
+            count = array.size();
+            src = float_stream(array.ptr(), count, scratch);
+            r_record.kind = ELEMENT_VECTOR2;
+            r_bytes.assign(static_cast<const uint8_t *>(src), static_cast<const uint8_t *>(src) + count * element_size(r_record.kind));
+        } break;
+        case Variant::PACKED_COLOR_ARRAY: {
+            const PackedColorArray array = value;
+            count = array.size();
+            r_record.kind = ELEMENT_COLOR;
+            r_bytes.resize(count * element_size(r_record.kind));
+            memcpy(r_bytes.data(), array.ptr(), r_bytes.size());
+        } break;
+        case Variant::PACKED_FLOAT32_ARRAY: {
+            const PackedFloat32Array array = value;
+            count = array.size();
+            r_record.kind = ELEMENT_FLOAT32;
+            r_bytes.resize(count * element_size(r_record.kind));
+            memcpy(r_bytes.data(), array.ptr(), r_bytes.size());
+        } break;
+        case Variant::PACKED_INT32_ARRAY: {
+            const PackedInt32Array array = value;
+            count = array.size();
+            r_record.kind = ELEMENT_INT32;
+            r_bytes.resize(count * element_size(r_record.kind));
+            memcpy(r_bytes.data(), array.ptr(), r_bytes.size());
+        } break;
+        case Variant::PACKED_BYTE_ARRAY: {
+            const PackedByteArray array = value;
+            count = array.size();
+            r_record.kind = ELEMENT_BYTE;
+            r_bytes.resize(count);
+            memcpy(r_bytes.data(), array.ptr(), count);
+        } break;
+        default:
+            return false;
+    }
+
+    size_t per_vertex = count / vertex_count;
+    if (per_vertex == 0 || per_vertex * vertex_count != count || per_vertex > 0xFFFF) {
+        return false;
+    }
+
+    r_record.per_vertex = static_cast<uint16_t>(per_vertex);
+    r_record.vertex_size = static_cast<uint16_t>(per_vertex * element_size(r_record.kind));
+    return true;
+}
+
+// The vertex codec works on 4 byte aligned vertices up to 256 bytes, as does the exp filter
+bool fits_vertex_codec(const StreamRecord &record) {
+    return record.vertex_size % 4 == 0 && record.vertex_size <= 256;
+}
+
+// Apply the lossy filters requested in options, in place
+void filter_stream(const EncodeOptions &options, size_t vertex_count, StreamRecord &r_record, std::vector<uint8_t> &r_bytes) {
+    bool is_normal = r_record.array_type == Mesh::ARRAY_NORMAL && r_record.kind == ELEMENT_VECTOR3 && r_record.per_vertex == 1;
+    bool is_tangent = r_record.array_type == Mesh::ARRAY_TANGENT && r_record.kind == ELEMENT_FLOAT32 && r_record.per_vertex == 4;
+
+    if (options.normal_bits > 0 && (is_normal || is_tangent)) {
+        int bits = CLAMP(options.normal_bits, 1, 16);
+        size_t stride = bits <= 8 ? 4 : 8;
+
+        // Octahedral encoding takes xyzw; w carries the tangent binormal sign
+        std::vector<float> vectors(vertex_count * 4);
+        const float *src = reinterpret_cast<const float *>(r_bytes.data());
+        for (size_t i = 0; i < vertex_count; i++) {
+            vectors[i * 4 + 0] = src[i * (is_normal ? 3 : 4) + 0];
+            vectors[i * 4 + 1] = src[i * (is_normal ? 3 : 4) + 1];
+            vectors[i * 4 + 2] = src[i * (is_normal ? 3 : 4) + 2];
+            vectors[i * 4 + 3] = is_normal ? 0.0f : src[i * 4 + 3];
+        }
+
+        r_bytes.assign(vertex_count * stride, 0);
+        meshopt_encodeFilterOct(r_bytes.data(), vertex_count, stride, bits, vectors.data());
+        r_record.filter = FILTER_OCT;
+        r_record.vertex_size = static_cast<uint16_t>(stride);
+        return;
+    }
+
+    if (options.float_bits > 0 && is_float_kind(r_record.kind) && fits_vertex_codec(r_record)) {
+        int bits = CLAMP(options.float_bits, 1, 24);
+        std::vector<float> values(vertex_count * r_record.vertex_size / sizeof(float));
+        memcpy(values.data(), r_bytes.data(), r_bytes.size());
+        meshopt_encodeFilterExp(r_bytes.data(), vertex_count, r_record.vertex_size, bits, values.data(), meshopt_EncodeExpSeparate);
+        r_record.filter = FILTER_EXP;
+    }
+}
+
+bool encode_surface(const Array &mesh_arrays, const EncodeOptions &options, Writer &r_writer, String &r_error) {
+    if (mesh_arrays.size() < Mesh::ARRAY_MAX) {
+        r_error = "Invalid mesh arrays size";
+        return false;
+    }
+
+    Variant v_vertices = mesh_arrays[Mesh::ARRAY_VERTEX];
+    if (v_vertices.get_type() != Variant::PACKED_VECTOR3_ARRAY || PackedVector3Array(v_vertices).size() == 0) {
+        r_error = "Missing vertices";
+        return false;
+    }
+    size_t vertex_count = PackedVector3Array(v_vertices).size();
+
+    // Indices
+    std::vector<uint8_t> index_data;
+    uint8_t index_encoding = INDEX_NONE;
+    size_t index_count = 0;
+
+    Variant v_indices = mesh_arrays[Mesh::ARRAY_INDEX];
+    if (v_indices.get_type() == Variant::PACKED_INT32_ARRAY && PackedInt32Array(v_indices).size() > 0) {
+        const PackedInt32Array indices = v_indices;
+        index_count = indices.size();
+
+        if (index_count % 3 == 0) {
+            index_data.resize(meshopt_encodeIndexBufferBound(index_count, vertex_count));
+            index_data.resize(meshopt_encodeIndexBuffer(index_data.data(), index_data.size(), index_stream(indices), index_count));
+            index_encoding = INDEX_BUFFER_CODEC;
+        } else {
+            index_data.resize(meshopt_encodeIndexSequenceBound(index_count, vertex_count));
+            index_data.resize(meshopt_encodeIndexSequence(index_data.data(), index_data.size(), index_stream(indices), index_count));
+            index_encoding = INDEX_SEQUENCE_CODEC;
+        }
+    }
+
+    // Vertex streams
+    std::vector<StreamRecord> records;
+    std::vector<std::vector<uint8_t>> stream_data;
+
+    for (int i = 0; i < Mesh::ARRAY_MAX; i++) {
+        Variant value = mesh_arrays[i];
+        if (i == Mesh::ARRAY_INDEX || value.get_type() == Variant::NIL) {
+            continue;
+        }
+
+        StreamRecord record;
+        record.array_type = static_cast<uint8_t>(i);
+        std::vector<uint8_t> bytes;
+        if (!stream_bytes(value, vertex_count, record, bytes)) {
+            r_error = String("Array ") + String::num_int64(i) + " is not a per-vertex packed array";
+            return false;
+        }
+
+        filter_stream(options, vertex_count, record, bytes);
+
+        if (fits_vertex_codec(record)) {
+            std::vector<uint8_t> encoded(meshopt_encodeVertexBufferBound(vertex_count, record.vertex_size));
+            encoded.resize(meshopt_encodeVertexBuffer(encoded.data(), encoded.size(), bytes.data(), vertex_count, record.vertex_size));
+            bytes.swap(encoded);
+            record.encoding = ENCODING_VERTEX_CODEC;
+        }
+
+        record.data_size = static_cast<uint32_t>(bytes.size());
+        records.push_back(record);
+        stream_data.push_back(std::move(bytes));
+    }
+
+    r_writer.put_u32(static_cast<uint32_t>(vertex_count));
+    r_writer.put_u32(static_cast<uint32_t>(index_count));
+    r_writer.put_u16(static_cast<uint16_t>(records.size()));
+    r_writer.put_u8(index_encoding);
+    r_writer.put_u8(0);
+    r_writer.put_u32(static_cast<uint32_t>(index_data.size()));
+
+    for (const StreamRecord &record : records) {
+        r_writer.put_u8(record.array_type);
+        r_writer.put_u8(record.kind);
+        r_writer.put_u8(record.filter);
+        r_writer.put_u8(record.encoding);
+        r_writer.put_u16(record.per_vertex);
+        r_writer.put_u16(record.vertex_size);
+        r_writer.put_u32(record.data_size);
+    }
+
+    r_writer.put(index_data.data(), index_data.size());
+    for (const std::vector<uint8_t> &bytes : stream_data) {
+        r_writer.put(bytes.data(), bytes.size());
+    }
+
+    return true;
+}
+
+// Convert a decoded octahedral stream (snorm8/16 xyzw) back to float components
+void unpack_oct(const uint8_t *src, size_t vertex_count, size_t stride, size_t components, float *r_dst) {
+    for (size_t i = 0; i < vertex_count; i++) {
+        for (size_t c = 0; c < components; c++) {
+            float value;
+            if (stride == 4) {
+                value = static_cast<int8_t>(src[i * 4 + c]) / 127.0f;
+            } else {
+                int16_t v;
+                memcpy(&v, src + i * 8 + c * 2, sizeof(v));
+                value = v / 32767.0f;
+            }
+            r_dst[i * components + c] = value;
+        }
+    }
+}
+
+// Check that a stream record describes data decode_stream_value can convert, and that the
+// meshopt decoders it selects accept its layout (they only assert on what they cannot take)
+bool is_valid_record(const StreamRecord &record) {
+    size_t expected_size = element_size(record.kind) * record.per_vertex;
+    if (expected_size == 0) {
+        return false;
+    }
+    if (record.encoding == ENCODING_VERTEX_CODEC) {
+        if (!fits_vertex_codec(record)) {
+            return false;
+        }
+    } else if (record.encoding != ENCODING_RAW) {
+        return false;
+    }
+
+    switch (record.filter) {
+        case FILTER_NONE:
+            return record.vertex_size == expected_size;
+        case FILTER_OCT: {
+            // Only the layouts filter_stream writes: normals (xyz) and tangents (xyzw)
+            bool is_normal = record.kind == ELEMENT_VECTOR3 && record.per_vertex == 1;
+            bool is_tangent = record.kind == ELEMENT_FLOAT32 && record.per_vertex == 4;
+            return (is_normal || is_tangent) && (record.vertex_size == 4 || record.vertex_size == 8);
+        }
+        case FILTER_EXP:
+            return is_float_kind(record.kind) && record.vertex_size == expected_size && fits_vertex_codec(record);
+        default:
+            return false;
+    }
+}
+
+// Whether data_size bytes can hold vertex_count vertices of the record, checked before the
+// counts of a corrupt or truncated header are used to allocate anything
+bool fits_decoded_size(const StreamRecord &record, size_t data_size, size_t vertex_count) {
+    uint64_t decoded_size = static_cast<uint64_t>(vertex_count) * record.vertex_size;
+    if (record.encoding == ENCODING_VERTEX_CODEC) {
+        return decoded_size <= static_cast<uint64_t>(data_size) * MAX_VERTEX_EXPANSION;
+    }
+    return decoded_size <= data_size;
+}
+
+// Undo the vertex codec (or copy raw data) into vertex_count * vertex_size bytes at r_bytes
+bool decode_stream_bytes(const StreamRecord &record, const uint8_t *data, size_t data_size, size_t vertex_count, uint8_t *r_bytes) {
+    if (record.encoding == ENCODING_VERTEX_CODEC) {
+        return meshopt_decodeVertexBuffer(r_bytes, vertex_count, record.vertex_size, data, data_size) == 0;
+    }
+    if (data_size != vertex_count * record.vertex_size) {
+        return false;
+    }
+    memcpy(r_bytes, data, data_size);
+    return true;
+}
+
+// Unfilter decoded stream bytes (in place) into the Godot packed array for its element kind
+bool decode_stream_value(const StreamRecord &record, std::vector<uint8_t> &bytes, size_t vertex_count, Variant &r_value) {
+    size_t expected_size = element_size(record.kind) * record.per_vertex;
+
+    if (record.filter == FILTER_EXP) {
+        meshopt_decodeFilterExp(bytes.data(), vertex_count, record.vertex_size);
+    }
+
+    const float *floats = reinterpret_cast<const float *>(bytes.data());
+    std::vector<float> unpacked;
+    if (record.filter == FILTER_OCT) {
+        meshopt_decodeFilterOct(bytes.data(), vertex_count, record.vertex_size);
+        size_t components = expected_size / sizeof(float);
+        unpacked.resize(vertex_count * components);
+        unpack_oct(bytes.data(), vertex_count, record.vertex_size, components, unpacked.data());
+        floats = unpacked.data();
+    }
+
+    size_t count = vertex_count * record.per_vertex;
+    switch (record.kind) {
+        case ELEMENT_VECTOR3: {
+            PackedVector3Array array;
+            array.resize(count);
+            store_float_stream(array.ptrw(), floats, count);
+            r_value = array;
+        } break;
+        case ELEMENT_VECTOR2: {
+            PackedVector2Array array;
+            array.resize(count);
+            store_float_stream(array.ptrw(), floats, count);
+            r_value = array;
+        } break;
+        case ELEMENT_COLOR: {
+            PackedColorArray array;
+            array.resize(count);
+            memcpy(static_cast<void *>(array.ptrw()), floats, count * sizeof(Color));
+            r_value = array;
+        } break;
+        case ELEMENT_FLOAT32: {
+            PackedFloat32Array array;
+            array.resize(count);
+            memcpy(array.ptrw(), floats, count * sizeof(float));
+            r_value = array;
+        } break;
+        case ELEMENT_INT32: {
+            PackedInt32Array array;
+            array.resize(count);
+            memcpy(array.ptrw(), bytes.data(), count * sizeof(int32_t));
+            r_value = array;
+        } break;
+        case ELEMENT_BYTE: {
+            PackedByteArray array;
+            array.resize(count);
+            memcpy(array.ptrw(), bytes.data(), count);
+            r_value = array;
+        } break;
+        default:
+            return false;
+    }
+
+    return true;
+}
+
+// Decode one stream into the Godot packed array for its element kind
+bool decode_stream(const StreamRecord &record, const uint8_t *data, size_t vertex_count, Variant &r_value) {
+    if (!is_valid_record(record) || !fits_decoded_size(record, record.data_size, vertex_count)) {
+        return false;
+    }
+
+    std::vector<uint8_t> bytes(vertex_count * record.vertex_size);
+    if (!decode_stream_bytes(record, data, record.data_size, vertex_count, bytes.data())) {
+        return false;
+    }
+    return decode_stream_value(record, bytes, vertex_count, r_value);
+}
+
+} // namespace
+
+namespace godot {
+namespace mesh_codec {
+
+PackedByteArray encode_surfaces(const Array &surfaces, const EncodeOptions &options, String &r_error) {
+    PackedByteArray result;
+
+    if (surfaces.size() > 0xFFFF) {
+        r_error = "Too many surfaces";
+        return result;
+    }
+
+    std::vector<Writer> encoded(surfaces.size());
+    for (int64_t i = 0; i < surfaces.size(); i++) {
+        if (surfaces[i].get_type() != Variant::ARRAY || !encode_surface(surfaces[i], options, encoded[i], r_error)) {
+            if (r_error.is_empty()) {
+                r_error = "Surface is not an Array";
+            }
+            r_error = String("Surface ") + String::num_int64(i) + ": " + r_error;
+            return result;
+        }
+    }
+
+    Writer writer;
+    writer.put_u32(MAGIC);
+    writer.put_u16(VERSION);
+    writer.put_u16(static_cast<uint16_t>(surfaces.size()));
+
+    size_t offset = CONTAINER_HEADER_SIZE + encoded.size() * SURFACE_ENTRY_SIZE;
+    for (const Writer &surface : encoded) {
+        writer.put_u32(static_cast<uint32_t>(offset));
+        writer.put_u32(static_cast<uint32_t>(surface.bytes.size()));
+        offset += surface.bytes.size();
+    }
+
+    result.resize(offset);
+    uint8_t *w = result.ptrw();
+    memcpy(w, writer.bytes.data(), writer.bytes.size());
+    w += writer.bytes.size();
+    for (const Writer &surface : encoded) {
+        memcpy(w, surface.bytes.data(), surface.bytes.size());
+        w += surface.bytes.size();
+    }
+
+    return result;
+}
+
+int get_surface_count(const uint8_t *data, size_t size) {
+    Reader reader{ data, size };
+    if (!reader.can_read(CONTAINER_HEADER_SIZE)) {
+        return -1;
+    }
+
+    uint32_t magic = reader.get_u32();
+    uint16_t version = reader.get_u16();
+    uint16_t surface_count = reader.get_u16();
+    if (magic != MAGIC || version != VERSION) {
+        return -1;
+    }
+    if (!reader.can_read(surface_count * SURFACE_ENTRY_SIZE)) {
+        return -1;
+    }
+
+    return surface_count;
+}
+
+Array decode_surface(const uint8_t *data, size_t size, int surface_index, String &r_error) {
+    Array result;
+
+    int surface_count = get_surface_count(data, size);
+    if (surface_count < 0) {
+        r_error = "Not a meshoptimizer surface container";
+        return result;
+    }
+    if (surface_index < 0 || surface_index >= surface_count) {
+        r_error = "Surface index out of range";
+        return result;
+    }
+
+    uint32_t surface_offset;
+    uint32_t surface_size;
+    memcpy(&surface_offset, data + CONTAINER_HEADER_SIZE + surface_index * SURFACE_ENTRY_SIZE, sizeof(uint32_t));
+    memcpy(&surface_size, data + CONTAINER_HEADER_SIZE + surface_index * SURFACE_ENTRY_SIZE + 4, sizeof(uint32_t));
+    if (surface_offset > size || surface_size > size - surface_offset) {
+        r_error = "Truncated container";
+        return result;
+    }
+
+    Reader reader{ data + surface_offset, surface_size };
+    if (!reader.can_read(SURFACE_HEADER_SIZE)) {
+        r_error = "Truncated surface header";
+        return result;
+    }
+
+    size_t vertex_count = reader.get_u32();
+    size_t index_count = reader.get_u32();
+    size_t stream_count = reader.get_u16();
+    uint8_t index_encoding = reader.get_u8();
+    reader.get_u8();
+    size_t index_size = reader.get_u32();
+
+    if (!reader.can_read(stream_count * STREAM_RECORD_SIZE)) {
+        r_error = "Truncated stream records";
+        return result;
+    }
+
+    std::vector<StreamRecord> records(stream_count);
+    for (StreamRecord &record : records) {
+        record.array_type = reader.get_u8();
+        record.kind = reader.get_u8();
+        record.filter = reader.get_u8();
+        record.encoding = reader.get_u8();
+        record.per_vertex = reader.get_u16();
+        record.vertex_size = reader.get_u16();
+        record.data_size = reader.get_u32();
+    }
+
+    result.resize(Mesh::ARRAY_MAX);
+
+    if (!reader.can_read(index_size)) {
+        r_error = "Truncated index data";
+        return Array();
+    }
+    if (index_encoding != INDEX_NONE) {
+        if (index_count > index_size * MAX_INDEX_EXPANSION) {
+            r_error = "Corrupt index data";
+            return Array();
+        }
+        PackedInt32Array indices;
+        indices.resize(index_count);
+        int status = index_encoding == INDEX_BUFFER_CODEC
+            ? meshopt_decodeIndexBuffer(indices.ptrw(), index_count, sizeof(int32_t), reader.data + reader.offset, index_size)
+            : meshopt_decodeIndexSequence(indices.ptrw(), index_count, sizeof(int32_t), reader.data + reader.offset, index_size);
+
+        // The decoder is safe on garbage input but may emit out of range indices
+        const unsigned int *decoded = index_stream(indices);
+        for (size_t i = 0; status == 0 && i < index_count; i++) {
+            if (decoded[i] >= vertex_count) {
+                status = -1;
+            }
+        }
+        if (status != 0) {
+            r_error = "Corrupt index data";
+            return Array();
+        }
+        result[Mesh::ARRAY_INDEX] = indices;
+    }
+    reader.offset += index_size;
+
+    for (const StreamRecord &record : records) {
+        if (!reader.can_read(record.data_size) || record.array_type >= Mesh::ARRAY_MAX || record.array_type == Mesh::ARRAY_INDEX) {
+            r_error = "Corrupt stream record";
+            return Array();
+        }
+
+        Variant value;
+        if (!decode_stream(record, reader.data + reader.offset, vertex_count, value)) {
+            r_error = String("Corrupt data in array ") + String::num_int64(record.array_type);
+            return Array();
+        }
+        result[record.array_type] = value;
+        reader.offset += record.data_size;
+    }
+
+    return result;
+}
+
+PackedByteArray encode_progressive(const Array &mesh_arrays, const std::vector<ProgressiveLevel> &levels, const EncodeOptions &options, String &r_error) {
+    PackedByteArray result;
+
+    if (mesh_arrays.size() < Mesh::ARRAY_MAX) {
+        r_error = "Invalid mesh arrays size";
+        return result;
+    }
+
+    Variant v_vertices = mesh_arrays[Mesh::ARRAY_VERTEX];
+    if (v_vertices.get_type() != Variant::PACKED_VECTOR3_ARRAY || PackedVector3Array(v_vertices).size() == 0) {
+        r_error = "Missing vertices";
+        return result;
+    }
+    if (levels.empty() || levels.size() > 0xFF) {
+        r_error = "Need 1 to 255 levels";
+        return result;
+    }
+    size_t vertex_count = PackedVector3Array(v_vertices).size();
+
+    // Cache-optimize every level, then number vertices by first use, coarsest level first:
+    // each chunk then only adds vertices, in the order its own indices fetch them
+    std::vector<std::vector<unsigned int>> level_indices(levels.size());
+    for (size_t k = 0; k < levels.size(); k++) {
+        const PackedInt32Array &indices = levels[k].indices;
+        size_t index_count = indices.size();
+        if (index_count == 0 || index_count % 3 != 0) {
+            r_error = String("Level ") + String::num_int64(k) + " is not a triangle list";
+            return result;
+        }
+        const unsigned int *src = index_stream(indices);
+        for (size_t i = 0; i < index_count; i++) {
+            if (src[i] >= vertex_count) {
+                r_error = String("Level ") + String::num_int64(k) + " has out of range indices";
+                return result;
+            }
+        }
+        level_indices[k].resize(index_count);
+        meshopt_optimizeVertexCache(level_indices[k].data(), src, index_count, vertex_count);
+    }
+
+    std::vector<unsigned int> remap(vertex_count, ~0u);
+    std::vector<uint32_t> level_vertex_counts(levels.size());
+    unsigned int next_vertex = 0;
+    for (size_t k = 0; k < levels.size(); k++) {
+        for (unsigned int &index : level_indices[k]) {
+            if (remap[index] == ~0u) {
+                remap[index] = next_vertex++;
+            }
+            index = remap[index];
+        }
+        level_vertex_counts[k] = next_vertex;
+    }
+    // Vertices no level references are dropped
+    size_t used_vertex_count = next_vertex;
+
+    // Vertex streams, filtered once and reordered for the chunks
+    std::vector<StreamRecord> records;
+    std::vector<std::vector<uint8_t>> stream_data;
+
+    for (int i = 0; i < Mesh::ARRAY_MAX; i++) {
+        Variant value = mesh_arrays[i];
+        if (i == Mesh::ARRAY_INDEX || value.get_type() == Variant::NIL) {
+            continue;
+        }
+
+        StreamRecord record;
+        record.array_type = static_cast<uint8_t>(i);
+        std::vector<uint8_t> bytes;
+        if (!stream_bytes(value, vertex_count, record, bytes)) {
+            r_error = String("Array ") + String::num_int64(i) + " is not a per-vertex packed array";
+            return result;
+        }
+
+        filter_stream(options, vertex_count, record, bytes);
+        if (fits_vertex_codec(record)) {
+            record.encoding = ENCODING_VERTEX_CODEC;
+        }
+
+        std::vector<uint8_t> ordered(used_vertex_count * record.vertex_size);
+        meshopt_remapVertexBuffer(ordered.data(), bytes.data(), vertex_count, record.vertex_size, remap.data());
+        records.push_back(record);
+        stream_data.push_back(std::move(ordered));
+    }
+
+    if (records.size() > 0xFF) {
+        r_error = "Too many vertex arrays";
+        return result;
+    }
+
+    // Chunks first, their ends go into the level table
+    std::vector<Writer> chunks(levels.size());
+    for (size_t k = 0; k < levels.size(); k++) {
+        const std::vector<unsigned int> &indices = level_indices[k];
+        size_t first_vertex = k == 0 ? 0 : level_vertex_counts[k - 1];
+        size_t chunk_vertex_count = level_vertex_counts[k] - first_vertex;
+
+        std::vector<uint8_t> index_data(meshopt_encodeIndexBufferBound(indices.size(), level_vertex_counts[k]));
+        index_data.resize(meshopt_encodeIndexBuffer(index_data.data(), index_data.size(), indices.data(), indices.size()));
+
+        std::vector<std::vector<uint8_t>> chunk_streams(records.size());
+        for (size_t s = 0; s < records.size(); s++) {
+            const uint8_t *src = stream_data[s].data() + first_vertex * records[s].vertex_size;
+            if (chunk_vertex_count == 0) {
+                continue;
+            }
+            if (records[s].encoding == ENCODING_VERTEX_CODEC) {
+                chunk_streams[s].resize(meshopt_encodeVertexBufferBound(chunk_vertex_count, records[s].vertex_size));
+                chunk_streams[s].resize(meshopt_encodeVertexBuffer(chunk_streams[s].data(), chunk_streams[s].size(), src, chunk_vertex_count, records[s].vertex_size));
+            } else {
+                chunk_streams[s].assign(src, src + chunk_vertex_count * records[s].vertex_size);
+            }
+        }
+
+        Writer &chunk = chunks[k];
+        chunk.put_u32(static_cast<uint32_t>(index_data.size()));
+        for (const std::vector<uint8_t> &bytes : chunk_streams) {
+            chunk.put_u32(static_cast<uint32_t>(bytes.size()));
+        }
+        chunk.put(index_data.data(), index_data.size());
+        for (const std::vector<uint8_t> &bytes : chunk_streams) {
+            chunk.put(bytes.data(), bytes.size());
+        }
+    }
+
+    Writer writer;
+    writer.put_u32(PROGRESSIVE_MAGIC);
+    writer.put_u16(PROGRESSIVE_VERSION);
+    writer.put_u8(static_cast<uint8_t>(levels.size()));
+    writer.put_u8(static_cast<uint8_t>(records.size()));
+    writer.put_u32(static_cast<uint32_t>(used_vertex_count));
+
+    for (const StreamRecord &record : records) {
+        writer.put_u8(record.array_type);
+        writer.put_u8(record.kind);
+        writer.put_u8(record.filter);
+        writer.put_u8(record.encoding);
+        writer.put_u16(record.per_vertex);
+        writer.put_u16(record.vertex_size);
+    }
+
+    size_t end = PROGRESSIVE_HEADER_SIZE + records.size() * PROGRESSIVE_STREAM_SIZE + levels.size() * PROGRESSIVE_LEVEL_SIZE;
+    for (size_t k = 0; k < levels.size(); k++) {
+        end += chunks[k].bytes.size();
+        if (end > 0xFFFFFFFFu) {
+            r_error = "Surface too large";
+            return result;
+        }
+        writer.put_u32(level_vertex_counts[k]);
+        writer.put_u32(static_cast<uint32_t>(level_indices[k].size()));
+        writer.put_u32(static_cast<uint32_t>(end));
+        writer.put(&levels[k].world_error, sizeof(float));
+    }
+
+    result.resize(end);
+    uint8_t *w = result.ptrw();
+    memcpy(w, writer.bytes.data(), writer.bytes.size());
+    w += writer.bytes.size();
+    for (const Writer &chunk : chunks) {
+        memcpy(w, chunk.bytes.data(), chunk.bytes.size());
+        w += chunk.bytes.size();
+    }
+
+    return result;
+}
+
+bool get_progressive_info(const uint8_t *data, size_t size, ProgressiveInfo &r_info, String &r_error) {
+    r_info = ProgressiveInfo();
+
+    Reader reader{ data, size };
+    if (!reader.can_read(PROGRESSIVE_HEADER_SIZE)) {
+        r_error = "Truncated progressive header";
+        return false;
+    }
+
+    uint32_t magic = reader.get_u32();
+    uint16_t version = reader.get_u16();
+    size_t level_count = reader.get_u8();
+    size_t stream_count = reader.get_u8();
+    if (magic != PROGRESSIVE_MAGIC || version != PROGRESSIVE_VERSION) {
+        r_error = "Not a meshoptimizer progressive surface";
+        return false;
+    }
+
+    r_info.vertex_count = reader.get_u32();
+    r_info.stream_count = stream_count;
+    r_info.header_size = PROGRESSIVE_HEADER_SIZE + stream_count * PROGRESSIVE_STREAM_SIZE + level_count * PROGRESSIVE_LEVEL_SIZE;
+    if (size < r_info.header_size) {
+        r_error = "Truncated progressive header";
+        return false;
+    }
+
+    reader.offset += stream_count * PROGRESSIVE_STREAM_SIZE;
+    r_info.levels.resize(level_count);
+    uint32_t previous_end = static_cast<uint32_t>(r_info.header_size);
+    uint32_t previous_vertex_count = 0;
+    for (ProgressiveLevelInfo &level : r_info.levels) {
+        level.vertex_count = reader.get_u32();
+        level.index_count = reader.get_u32();
+        level.end = reader.get_u32();
+        memcpy(&level.world_error, reader.data + reader.offset, sizeof(float));
+        reader.offset += sizeof(float);
+
+        if (level.end < previous_end || level.vertex_count < previous_vertex_count || level.vertex_count > r_info.vertex_count) {
+            r_error = "Corrupt progressive level table";
+            return false;
+        }
+        previous_end = level.end;
+        previous_vertex_count = level.vertex_count;
+
+        if (level.end <= size) {
+            r_info.loaded_levels++;
+        }
+    }
+
+    return true;
+}
+
+Array decode_progressive(const uint8_t *data, size_t size, int level, String &r_error) {
+    Array result;
+
+    ProgressiveInfo info;
+    if (!get_progressive_info(data, size, info, r_error)) {
+        return result;
+    }
+    if (level < 0) {
+        level = info.loaded_levels - 1;
+        if (level < 0) {
+            r_error = "No complete level in the data yet";
+            return result;
+        }
+    }
+    if (level >= static_cast<int>(info.levels.size())) {
+        r_error = "Level out of range";
+        return result;
+    }
+    if (level >= info.loaded_levels) {
+        r_error = "Level not loaded yet";
+        return result;
+    }
+
+    Reader reader{ data, size, PROGRESSIVE_HEADER_SIZE };
+    std::vector<StreamRecord> records(info.stream_count);
+    for (StreamRecord &record : records) {
+        record.array_type = reader.get_u8();
+        record.kind = reader.get_u8();
+        record.filter = reader.get_u8();
+        record.encoding = reader.get_u8();
+        record.per_vertex = reader.get_u16();
+        record.vertex_size = reader.get_u16();
+
+        if (!is_valid_record(record) || record.array_type >= Mesh::ARRAY_MAX || record.array_type == Mesh::ARRAY_INDEX) {
+            r_error = "Corrupt stream record";
+            return result;
+        }
+    }
+
+    size_t vertex_count = info.levels[level].vertex_count;
+    size_t index_count = info.levels[level].index_count;
+    // The chunks up to the level hold every vertex it decodes to
+    std::vector<std::vector<uint8_t>> streams(records.size());
+    for (size_t s = 0; s < records.size(); s++) {
+        if (!fits_decoded_size(records[s], info.levels[level].end - info.header_size, vertex_count)) {
+            r_error = String("Corrupt data in array ") + String::num_int64(records[s].array_type);
+            return result;
+        }
+        streams[s].resize(vertex_count * records[s].vertex_size);
+    }
+
+    // Vertices accumulate over the chunks up to the level, only its own indices are needed
+    PackedInt32Array indices;
+    size_t chunk_start = info.header_size;
+    for (int k = 0; k <= level; k++) {
+        const ProgressiveLevelInfo &chunk_level = info.levels[k];
+        size_t first_vertex = k == 0 ? 0 : info.levels[k - 1].vertex_count;
+        size_t chunk_vertex_count = chunk_level.vertex_count - first_vertex;
+
+        Reader chunk{ data + chunk_start, chunk_level.end - chunk_start };
+        chunk_start = chunk_level.end;
+        if (!chunk.can_read(sizeof(uint32_t) * (records.size() + 1))) {
+            r_error = "Truncated chunk header";
+            return Array();
+        }
+        size_t index_size = chunk.get_u32();
+        std::vector<size_t> stream_sizes(records.size());
+        for (size_t &stream_size : stream_sizes) {
+            stream_size = chunk.get_u32();
+        }
+
+        if (!chunk.can_read(index_size)) {
+            r_error = "Truncated index data";
+            return Array();
+        }
+        if (k == level) {
+            if (index_count > index_size * MAX_INDEX_EXPANSION) {
+                r_error = "Corrupt index data";
+                return Array();
+            }
+            indices.resize(index_count);
+            int status = meshopt_decodeIndexBuffer(indices.ptrw(), index_count, sizeof(int32_t), chunk.data + chunk.offset, index_size);
+
+            const unsigned int *decoded = index_stream(indices);
+            for (size_t i = 0; status == 0 && i < index_count; i++) {
+                if (decoded[i] >= vertex_count) {
+                    status = -1;
+                }
+            }
+            if (status != 0) {
+                r_error = "Corrupt index data";
+                return Array();
+            }
+        }
+        chunk.offset += index_size;
+
+        for (size_t s = 0; s < records.size(); s++) {
+            if (!chunk.can_read(stream_sizes[s])) {
+                r_error = "Truncated stream data";
+                return Array();
+            }
+            if (chunk_vertex_count > 0 && !decode_stream_bytes(records[s], chunk.data + chunk.offset, stream_sizes[s], chunk_vertex_count,
+                    streams[s].data() + first_vertex * records[s].vertex_size)) {
+                r_error = String("Corrupt data in array ") + String::num_int64(records[s].array_type);
+                return Array();
+            }
+            chunk.offset += stream_sizes[s];
+        }
+    }
+
+    result.resize(Mesh::ARRAY_MAX);
+    result[Mesh::ARRAY_INDEX] = indices;
+    for (size_t s = 0; s < records.size(); s++) {
+        Variant value;
+        if (!decode_stream_value(records[s], streams[s], vertex_count, value)) {
+            r_error = String("Corrupt data in array ") + String::num_int64(records[s].array_type);
+            return Array();
+        }
+        result[records[s].array_type] = value;
+    }
+
+    return result;
+}
+
+} // namespace mesh_codec
+} // namespace godot
@@ -0,0 +1,91 @@
+// MeshOptimizer GDExtension for Godot 4
+// Compressed binary container for Godot surfaces (vertex/index codecs)
+#ifndef MESHOPTIMIZER_CODEC_H
+#define MESHOPTIMIZER_CODEC_H
+
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/string.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace godot {
+namespace mesh_codec {
+
+// Container layout (little-endian):
+//   u32 magic 'MOPT', u16 version, u16 surface_count
+//   surface_count x { u32 offset, u32 size } from the start of the blob
+//   surfaces: u32 vertex_count, u32 index_count, u16 stream_count, u8 index_encoding,
+//     u8 reserved, u32 index_size, stream_count x 12 byte stream records, index data,
+//     stream data in record order
+// Each stream is one per-vertex surface array, stored as float32/int32/byte components
+// regardless of real_t precision, so blobs are portable between builds.
+// Triangle list indices may come back with each triangle's corners rotated (winding is kept).
+constexpr uint32_t MAGIC = 0x54504F4D; // "MOPT"
+constexpr uint16_t VERSION = 1;
+
+struct EncodeOptions {
+    // 0 = lossless; 1-16 = octahedral normal/tangent encoding with this many bits (8 or 16 bit storage)
+    int normal_bits = 0;
+    // 0 = lossless; 1-24 = mantissa bits kept by the exponential filter on float arrays
+    int float_bits = 0;
+};
+
+// Encode an Array of surface arrays into one container
+PackedByteArray encode_surfaces(const Array &surfaces, const EncodeOptions &options, String &r_error);
+
+// Number of surfaces in a container, -1 if the header is invalid
+int get_surface_count(const uint8_t *data, size_t size);
+
+// Decode one surface; returns an empty Array and sets r_error on malformed input
+// Safe to call from worker threads, only reads data
+Array decode_surface(const uint8_t *data, size_t size, int surface_index, String &r_error);
+
+// Progressive container, one surface refined coarse to fine so that any prefix holding the
+// header and the first k chunks decodes to level k (little-endian):
+//   u32 magic 'MOPP', u16 version, u8 level_count, u8 stream_count, u32 vertex_count
+//   stream_count x 8 byte stream records, level_count x { u32 vertex_count, u32 index_count,
+//     u32 end (offset of the end of its chunk), f32 world_error }
+//   chunks: u32 index_size, stream_count x u32 data_size, index data, stream data
+// Vertices are ordered by the level that first uses them, so level k uses the first
+// vertex_count of them and its chunk only adds the new ones; indices are stored per level.
+constexpr uint32_t PROGRESSIVE_MAGIC = 0x50504F4D; // "MOPP"
+constexpr uint16_t PROGRESSIVE_VERSION = 1;
+
+struct ProgressiveLevel {
+    PackedInt32Array indices; // Into the input vertex arrays
+    float world_error = 0.0f;
+};
+
+struct ProgressiveLevelInfo {
+    uint32_t vertex_count = 0;
+    uint32_t index_count = 0;
+    uint32_t end = 0;
+    float world_error = 0.0f;
+};
+
+struct ProgressiveInfo {
+    size_t header_size = 0; // Known once the fixed part is present, even if the rest is not
+    uint32_t vertex_count = 0;
+    size_t stream_count = 0;
+    std::vector<ProgressiveLevelInfo> levels;
+    int loaded_levels = 0; // Levels whose chunk is complete in the data
+};
+
+// Encode one surface from its levels, coarsest first; the last level is the full mesh
+PackedByteArray encode_progressive(const Array &mesh_arrays, const std::vector<ProgressiveLevel> &levels, const EncodeOptions &options, String &r_error);
+
+// Parse the header of a progressive container or a prefix of one
+bool get_progressive_info(const uint8_t *data, size_t size, ProgressiveInfo &r_info, String &r_error);
+
+// Decode one level (-1 = the finest complete one) from a container or a prefix of one
+// Safe to call from worker threads, only reads data
+Array decode_progressive(const uint8_t *data, size_t size, int level, String &r_error);
+
+} // namespace mesh_codec
+} // namespace godot
+
+#endif // MESHOPTIMIZER_CODEC_H
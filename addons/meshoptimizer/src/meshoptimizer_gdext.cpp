@@ -2,429 +2,3200 @@
 // Implementation wrapping meshoptimizer library
 
 #include "meshoptimizer_gdext.h"
+#include "meshoptimizer_streams.h"
+#include "meshoptimizer_codec.h"
+#include "meshoptimizer_arena.h"
+#include "meshoptimizer_impostor.h"
+#include "meshoptimizer_stats.h"
+#include "meshoptimizer_cache.h"
+#include "meshoptimizer_surface.h"
 #include "../thirdparty/meshoptimizer.h"
 
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
+#include <godot_cpp/classes/dir_access.hpp>
+#include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/json.hpp>
 #include <godot_cpp/classes/mesh.hpp>
+#include <godot_cpp/classes/performance.hpp>
+#include <godot_cpp/classes/resource_loader.hpp>
+#include <godot_cpp/variant/packed_color_array.hpp>
+#include <godot_cpp/variant/aabb.hpp>
+#include <godot_cpp/variant/rect2.hpp>
+#include <godot_cpp/variant/callable_method_pointer.hpp>
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <numeric>
 #include <vector>
 #include <cstring>
 
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define PSAPI_VERSION 2 // K32GetProcessMemoryInfo, exported by kernel32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
 using namespace godot;
+using namespace godot::mesh_streams;
+
+namespace {
+
+uint64_t now_usec() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Interleaved per-vertex attribute floats for meshopt_simplifyWithAttributes
+struct AttributeStream {
+    std::vector<float> data;
+    std::vector<float> weights; // One per float component
+
+    size_t component_count() const { return weights.size(); }
+    size_t stride() const { return weights.size() * sizeof(float); }
+    bool empty() const { return weights.empty(); }
+};
+
+// meshopt_Simplify* flags and per-vertex locks for the topology-preserving simplifier
+struct SimplifyOptions {
+    unsigned int flags = 0;
+    std::vector<unsigned char> vertex_lock; // One per vertex when not empty
+
+    const unsigned char *lock() const { return vertex_lock.empty() ? nullptr : vertex_lock.data(); }
+};
+
+// Components of each weighable Godot array; tangent w is only the binormal sign and is skipped
+int attribute_components(int array_type, Variant::Type &r_type) {
+    switch (array_type) {
+        case Mesh::ARRAY_NORMAL: r_type = Variant::PACKED_VECTOR3_ARRAY; return 3;
+        case Mesh::ARRAY_TANGENT: r_type = Variant::PACKED_FLOAT32_ARRAY; return 3;
+        case Mesh::ARRAY_COLOR: r_type = Variant::PACKED_COLOR_ARRAY; return 4;
+        case Mesh::ARRAY_TEX_UV: r_type = Variant::PACKED_VECTOR2_ARRAY; return 2;
+        case Mesh::ARRAY_TEX_UV2: r_type = Variant::PACKED_VECTOR2_ARRAY; return 2;
+        default: return 0;
+    }
+}
+
+// Pack weighted surface attributes into one interleaved stream
+// attribute_weights maps Mesh.ArrayType to weight; empty means UVs at weight 1.0.
+// Missing arrays, arrays of the wrong size and weights <= 0 are skipped.
+void build_attribute_stream(const Array &mesh_arrays, size_t vertex_count, const Dictionary &attribute_weights, AttributeStream &r_stream) {
+    static const int order[] = { Mesh::ARRAY_TEX_UV, Mesh::ARRAY_TEX_UV2, Mesh::ARRAY_NORMAL, Mesh::ARRAY_TANGENT, Mesh::ARRAY_COLOR };
+
+    struct Source {
+        Variant array;
+        int array_type;
+        int components;
+        size_t offset;
+    };
+    std::vector<Source> sources;
+
+    r_stream.data.clear();
+    r_stream.weights.clear();
+
+    for (int array_type : order) {
+        float weight = 0.0f;
+        if (attribute_weights.is_empty()) {
+            weight = array_type == Mesh::ARRAY_TEX_UV ? 1.0f : 0.0f;
+        } else {
+            weight = attribute_weights.get(array_type, 0.0f);
+        }
+        if (weight <= 0.0f) {
+            continue;
+        }
+
+        Variant::Type expected_type;
+        int components = attribute_components(array_type, expected_type);
+        Variant array = mesh_arrays[array_type];
+        if (array.get_type() != expected_type) {
+            continue;
+        }
+
+        size_t element_count = 0;
+        switch (array_type) {
+            case Mesh::ARRAY_NORMAL: element_count = PackedVector3Array(array).size(); break;
+            case Mesh::ARRAY_TANGENT: element_count = PackedFloat32Array(array).size() / 4; break;
+            case Mesh::ARRAY_COLOR: element_count = PackedColorArray(array).size(); break;
+            default: element_count = PackedVector2Array(array).size(); break;
+        }
+        if (element_count != vertex_count || r_stream.weights.size() + components > 16) {
+            continue;
+        }
+
+        sources.push_back({ array, array_type, components, r_stream.weights.size() });
+        r_stream.weights.insert(r_stream.weights.end(), components, weight);
+    }
+
+    if (sources.empty()) {
+        return;
+    }
+
+    const size_t stride = r_stream.component_count();
+    r_stream.data.resize(vertex_count * stride);
+    float *dst = r_stream.data.data();
+
+    for (const Source &source : sources) {
+        switch (source.array_type) {
+            case Mesh::ARRAY_NORMAL: {
+                PackedVector3Array normals = source.array;
+                const Vector3 *src = normals.ptr();
+                for (size_t i = 0; i < vertex_count; i++) {
+                    float *out = dst + i * stride + source.offset;
+                    out[0] = src[i].x;
+                    out[1] = src[i].y;
+                    out[2] = src[i].z;
+                }
+            } break;
+            case Mesh::ARRAY_TANGENT: {
+                PackedFloat32Array tangents = source.array;
+                const float *src = tangents.ptr();
+                for (size_t i = 0; i < vertex_count; i++) {
+                    memcpy(dst + i * stride + source.offset, src + i * 4, sizeof(float) * 3);
+                }
+            } break;
+            case Mesh::ARRAY_COLOR: {
+                PackedColorArray colors = source.array;
+                const Color *src = colors.ptr();
+                for (size_t i = 0; i < vertex_count; i++) {
+                    memcpy(dst + i * stride + source.offset, &src[i], sizeof(float) * 4);
+                }
+            } break;
+            default: {
+                PackedVector2Array uvs = source.array;
+                const Vector2 *src = uvs.ptr();
+                for (size_t i = 0; i < vertex_count; i++) {
+                    float *out = dst + i * stride + source.offset;
+                    out[0] = src[i].x;
+                    out[1] = src[i].y;
+                }
+            } break;
+        }
+    }
+}
+
+// Reads "flags" (MeshOptimizerGD.SimplifyFlags), "vertex_lock" (PackedByteArray, non-zero = locked)
+// and "lock_aabb" (AABB; vertices within "lock_tolerance" of one of its faces are locked)
+void build_simplify_options(const Dictionary &options, const float *positions, size_t vertex_count, SimplifyOptions &r_options) {
+    r_options.flags = static_cast<unsigned int>(int(options.get("flags", 0))) &
+        (meshopt_SimplifyLockBorder | meshopt_SimplifySparse | meshopt_SimplifyErrorAbsolute);
+    r_options.vertex_lock.clear();
+
+    Variant v_lock = options.get("vertex_lock", Variant());
+    if (v_lock.get_type() == Variant::PACKED_BYTE_ARRAY) {
+        const PackedByteArray lock = v_lock;
+        if (static_cast<size_t>(lock.size()) == vertex_count) {
+            r_options.vertex_lock.resize(vertex_count);
+            for (size_t i = 0; i < vertex_count; i++) {
+                r_options.vertex_lock[i] = lock[i] ? 1 : 0;
+            }
+        } else if (lock.size() > 0) {
+            UtilityFunctions::push_error("MeshOptimizerGD: vertex_lock size does not match the vertex count, ignored");
+        }
+    }
+
+    Variant v_aabb = options.get("lock_aabb", Variant());
+    if (v_aabb.get_type() == Variant::AABB) {
+        AABB aabb = v_aabb;
+        float tolerance = options.get("lock_tolerance", 0.0001f);
+        Vector3 lo = aabb.position;
+        Vector3 hi = aabb.position + aabb.size;
+
+        r_options.vertex_lock.resize(vertex_count, 0);
+        for (size_t i = 0; i < vertex_count; i++) {
+            const float *p = positions + i * 3;
+            for (int c = 0; c < 3; c++) {
+                if (std::abs(p[c] - lo[c]) <= tolerance || std::abs(p[c] - hi[c]) <= tolerance) {
+                    r_options.vertex_lock[i] = 1;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// Simplify an index buffer, weighing attributes when the stream has any
+size_t simplify_indices(
+    unsigned int *destination,
+    const unsigned int *indices,
+    size_t index_count,
+    const float *positions,
+    size_t vertex_count,
+    const AttributeStream &attributes,
+    size_t target_index_count,
+    float target_error,
+    const SimplifyOptions &options,
+    float *result_error
+) {
+    mesh_stats::Kernel kernel;
+
+    // Vertex locks are only taken by the attribute variant, which also works with no attributes
+    if (attributes.empty() && !options.lock()) {
+        return meshopt_simplify(
+            destination, indices, index_count,
+            positions, vertex_count, float_stride<Vector3>(),
+            target_index_count, target_error, options.flags, result_error
+        );
+    }
+
+    return meshopt_simplifyWithAttributes(
+        destination, indices, index_count,
+        positions, vertex_count, float_stride<Vector3>(),
+        attributes.empty() ? nullptr : attributes.data.data(), attributes.stride(),
+        attributes.empty() ? nullptr : attributes.weights.data(), attributes.component_count(),
+        options.lock(),
+        target_index_count, target_error, options.flags, result_error
+    );
+}
+
+// The surface's index buffer; non-indexed surfaces get a trivial one so every pass has one to work on
+PackedInt32Array surface_indices(const Variant &v_indices, size_t vertex_count) {
+    if (v_indices.get_type() == Variant::PACKED_INT32_ARRAY && PackedInt32Array(v_indices).size() > 0) {
+        return v_indices;
+    }
+    PackedInt32Array indices;
+    indices.resize(vertex_count);
+    fill_sequential(reinterpret_cast<uint32_t *>(indices.ptrw()), vertex_count);
+    return indices;
+}
+
+// A triangle list whose every index points at one of vertex_count vertices; meshoptimizer only
+// asserts this, so user data is checked before it reaches a kernel or an index-addressed buffer
+bool valid_triangle_indices(const PackedInt32Array &indices, size_t vertex_count) {
+    if (indices.size() % 3 != 0) {
+        return false;
+    }
+    const int32_t *r = indices.ptr();
+    for (int64_t i = 0; i < indices.size(); i++) {
+        if (r[i] < 0 || static_cast<size_t>(r[i]) >= vertex_count) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Build an old -> new vertex remap for the vertices an index buffer references, in first-use
+// order (which is also the vertex fetch friendly order); unreferenced vertices map to -1
+// r_remap is resized in place, so a buffer kept across calls is reused; returns the unique count
+size_t build_fetch_remap_into(PackedInt32Array &r_remap, const PackedInt32Array &indices, size_t vertex_count) {
+    r_remap.resize(vertex_count);
+    mesh_stats::Kernel kernel;
+    return meshopt_optimizeVertexFetchRemap(
+        index_stream_w(r_remap),
+        index_stream(indices),
+        indices.size(),
+        vertex_count
+    );
+}
+
+PackedInt32Array build_fetch_remap(const PackedInt32Array &indices, size_t vertex_count, size_t &r_unique_count) {
+    PackedInt32Array remap;
+    r_unique_count = build_fetch_remap_into(remap, indices, vertex_count);
+    return remap;
+}
+
+// Remap a one-element-per-vertex array into r_dst, reusing its storage
+template <typename T>
+void remap_packed_into(T &r_dst, const T &src, size_t vertex_count, size_t unique_count, const PackedInt32Array &remap) {
+    r_dst.resize(unique_count);
+    mesh_stats::Kernel kernel;
+    meshopt_remapVertexBuffer(r_dst.ptrw(), src.ptr(), vertex_count, sizeof(*src.ptr()), index_stream(remap));
+}
+
+template <typename T>
+Variant remap_packed(const Variant &value, size_t vertex_count, size_t unique_count, const unsigned int *remap) {
+    const T array = value;
+    size_t per_vertex = static_cast<size_t>(array.size()) / vertex_count;
+
+    // Not a per-vertex array (or malformed), nothing sensible to remap
+    if (per_vertex == 0 || per_vertex * vertex_count != static_cast<size_t>(array.size())) {
+        return value;
+    }
+
+    T remapped;
+    remapped.resize(unique_count * per_vertex);
+    mesh_stats::Kernel kernel;
+    meshopt_remapVertexBuffer(
+        remapped.ptrw(),
+        array.ptr(),
+        vertex_count,
+        sizeof(*array.ptr()) * per_vertex,
+        remap
+    );
+    return remapped;
+}
+
+// Remap one per-vertex surface array; components per vertex are derived from the array size,
+// so tangents, custom channels and 4/8 bone skinning data go through the same path
+Variant remap_vertex_array(const Variant &value, size_t vertex_count, size_t unique_count, const unsigned int *remap) {
+    switch (value.get_type()) {
+        case Variant::PACKED_VECTOR3_ARRAY: return remap_packed<PackedVector3Array>(value, vertex_count, unique_count, remap);
+        case Variant::PACKED_VECTOR2_ARRAY: return remap_packed<PackedVector2Array>(value, vertex_count, unique_count, remap);
+        case Variant::PACKED_COLOR_ARRAY: return remap_packed<PackedColorArray>(value, vertex_count, unique_count, remap);
+        case Variant::PACKED_FLOAT32_ARRAY: return remap_packed<PackedFloat32Array>(value, vertex_count, unique_count, remap);
+        case Variant::PACKED_INT32_ARRAY: return remap_packed<PackedInt32Array>(value, vertex_count, unique_count, remap);
+        case Variant::PACKED_BYTE_ARRAY: return remap_packed<PackedByteArray>(value, vertex_count, unique_count, remap);
+        default: return value;
+    }
+}
+
+// Drop vertices the index buffer no longer references from every array of the surface
+// indices are rewritten in place to the compacted vertex order
+Array compact_surface(const Array &mesh_arrays, PackedInt32Array &indices, size_t vertex_count) {
+    size_t unique_count = 0;
+    PackedInt32Array remap = build_fetch_remap(indices, vertex_count, unique_count);
+    const unsigned int *remap_data = index_stream(remap);
+
+    meshopt_remapIndexBuffer(index_stream_w(indices), index_stream(indices), indices.size(), remap_data);
+
+    Array result;
+    result.resize(Mesh::ARRAY_MAX);
+    for (int i = 0; i < Mesh::ARRAY_MAX; i++) {
+        if (i == Mesh::ARRAY_INDEX) {
+            result[i] = indices;
+        } else {
+            result[i] = remap_vertex_array(mesh_arrays[i], vertex_count, unique_count, remap_data);
+        }
+    }
+    return result;
+}
+
+template <typename T>
+bool add_packed_stream(const Variant &value, size_t vertex_count, std::vector<Variant> &r_held, std::vector<meshopt_Stream> &r_streams) {
+    const T array = value;
+    size_t per_vertex = static_cast<size_t>(array.size()) / vertex_count;
+    if (per_vertex == 0 || per_vertex * vertex_count != static_cast<size_t>(array.size())) {
+        return false;
+    }
+
+    size_t vertex_size = sizeof(*array.ptr()) * per_vertex;
+    r_streams.push_back({ array.ptr(), vertex_size, vertex_size });
+    r_held.push_back(array); // Keeps the buffer alive for the stream pointer
+    return true;
+}
+
+// Byte streams of every per-vertex array of a surface, for meshopt_*Multi functions
+void collect_vertex_streams(const Array &mesh_arrays, size_t vertex_count, std::vector<Variant> &r_held, std::vector<meshopt_Stream> &r_streams) {
+    for (int i = 0; i < Mesh::ARRAY_MAX; i++) {
+        if (i == Mesh::ARRAY_INDEX) {
+            continue;
+        }
+
+        Variant value = mesh_arrays[i];
+        switch (value.get_type()) {
+            case Variant::PACKED_VECTOR3_ARRAY: add_packed_stream<PackedVector3Array>(value, vertex_count, r_held, r_streams); break;
+            case Variant::PACKED_VECTOR2_ARRAY: add_packed_stream<PackedVector2Array>(value, vertex_count, r_held, r_streams); break;
+            case Variant::PACKED_COLOR_ARRAY: add_packed_stream<PackedColorArray>(value, vertex_count, r_held, r_streams); break;
+            case Variant::PACKED_FLOAT32_ARRAY: add_packed_stream<PackedFloat32Array>(value, vertex_count, r_held, r_streams); break;
+            case Variant::PACKED_INT32_ARRAY: add_packed_stream<PackedInt32Array>(value, vertex_count, r_held, r_streams); break;
+            case Variant::PACKED_BYTE_ARRAY: add_packed_stream<PackedByteArray>(value, vertex_count, r_held, r_streams); break;
+            default: break;
+        }
+    }
+}
+
+mesh_codec::EncodeOptions encode_options(const Dictionary &options) {
+    mesh_codec::EncodeOptions result;
+    result.normal_bits = options.get("normal_bits", 0);
+    result.float_bits = options.get("float_bits", 0);
+    return result;
+}
+
+struct ErrorStats {
+    double max_error = 0.0;
+    double sum = 0.0;
+    size_t count = 0;
+
+    void add(double error) {
+        max_error = MAX(max_error, error);
+        sum += error;
+        count++;
+    }
+
+    double average() const { return count > 0 ? sum / count : 0.0; }
+};
+
+enum QuantizeFormat {
+    QUANTIZE_COMPRESSED,
+    QUANTIZE_HALF,
+    QUANTIZE_FLOAT,
+};
+
+float quantize_scalar(float value, QuantizeFormat format, int float_bits) {
+    if (format == QUANTIZE_HALF) {
+        return meshopt_dequantizeHalf(meshopt_quantizeHalf(value));
+    }
+    return meshopt_quantizeFloat(value, float_bits);
+}
+
+// 16-bit unorm over [min, min + size], as Godot's compressed vertex format stores positions and UVs
+float quantize_range16(float value, float min, float size) {
+    if (size <= 0.0f) {
+        return min;
+    }
+    int q = meshopt_quantizeUnorm((value - min) / size, 16);
+    return min + (q / 65535.0f) * size;
+}
+
+// Round trip unit vectors through 16-bit octahedral encoding; xyzw in, xyz snapped in place
+void quantize_octahedral(std::vector<float> &r_vectors, size_t count) {
+    std::vector<int16_t> encoded(count * 4);
+    meshopt_encodeFilterOct(encoded.data(), count, sizeof(int16_t) * 4, 16, r_vectors.data());
+    meshopt_decodeFilterOct(encoded.data(), count, sizeof(int16_t) * 4);
+    for (size_t i = 0; i < count; i++) {
+        for (int c = 0; c < 3; c++) {
+            r_vectors[i * 4 + c] = encoded[i * 4 + c] / 32767.0f;
+        }
+    }
+}
+
+double angle_degrees(const Vector3 &a, const Vector3 &b) {
+    real_t la = a.length();
+    real_t lb = b.length();
+    if (la <= 0 || lb <= 0) {
+        return 0.0;
+    }
+    double d = CLAMP(static_cast<double>(a.dot(b) / (la * lb)), -1.0, 1.0);
+    return std::acos(d) * 180.0 / Math_PI;
+}
+
+// fp16 components, padding each element to pad_to components (0 = no padding)
+PackedByteArray half_stream(const float *values, size_t element_count, size_t components, size_t pad_to) {
+    size_t stored = MAX(components, pad_to);
+    PackedByteArray bytes;
+    bytes.resize(element_count * stored * sizeof(uint16_t));
+    uint16_t *w = reinterpret_cast<uint16_t *>(bytes.ptrw());
+    for (size_t i = 0; i < element_count; i++) {
+        for (size_t c = 0; c < stored; c++) {
+            w[i * stored + c] = c < components ? meshopt_quantizeHalf(values[i * components + c]) : 0;
+        }
+    }
+    return bytes;
+}
+
+void collect_resource_files(const String &path, PackedStringArray &r_files) {
+    PackedStringArray files = DirAccess::get_files_at(path);
+    for (int i = 0; i < files.size(); i++) {
+        String extension = files[i].get_extension().to_lower();
+        if (extension == "res" || extension == "tres" || extension == "mesh") {
+            r_files.push_back(path.path_join(files[i]));
+        }
+    }
+
+    PackedStringArray directories = DirAccess::get_directories_at(path);
+    for (int i = 0; i < directories.size(); i++) {
+        collect_resource_files(path.path_join(directories[i]), r_files);
+    }
+}
+
+const char *ANALYSIS_METRICS[] = { "acmr", "atvr", "overdraw", "overfetch" };
+
+String analysis_csv(const Array &entries) {
+    String csv = "path,surface,vertex_count,triangle_count,vertex_size,acmr,atvr,overdraw,overfetch,vertices_transformed,failed\n";
+    for (int i = 0; i < entries.size(); i++) {
+        Dictionary entry = entries[i];
+        PackedStringArray failed = entry["failed"];
+        csv += String(entry["path"]) + "," + String::num_int64(entry["surface"]) + "," +
+            String::num_int64(entry["vertex_count"]) + "," + String::num_int64(entry["triangle_count"]) + "," +
+            String::num_int64(entry["vertex_size"]) + "," + String::num(entry["acmr"], 4) + "," +
+            String::num(entry["atvr"], 4) + "," + String::num(entry["overdraw"], 4) + "," +
+            String::num(entry["overfetch"], 4) + "," + String::num_int64(entry["vertices_transformed"]) + "," +
+            String(" ").join(failed) + "\n";
+    }
+    return csv;
+}
+
+// Per-vertex arrays merge_surfaces carries over besides positions
+const int MERGE_ARRAYS[] = { Mesh::ARRAY_NORMAL, Mesh::ARRAY_TANGENT, Mesh::ARRAY_COLOR, Mesh::ARRAY_TEX_UV, Mesh::ARRAY_TEX_UV2 };
+
+bool has_merge_array(const Array &mesh_arrays, int array_type, size_t vertex_count) {
+    Variant value = mesh_arrays[array_type];
+    switch (array_type) {
+        case Mesh::ARRAY_NORMAL:
+            return value.get_type() == Variant::PACKED_VECTOR3_ARRAY && static_cast<size_t>(PackedVector3Array(value).size()) == vertex_count;
+        case Mesh::ARRAY_TANGENT:
+            return value.get_type() == Variant::PACKED_FLOAT32_ARRAY && static_cast<size_t>(PackedFloat32Array(value).size()) == vertex_count * 4;
+        case Mesh::ARRAY_COLOR:
+            return value.get_type() == Variant::PACKED_COLOR_ARRAY && static_cast<size_t>(PackedColorArray(value).size()) == vertex_count;
+        default:
+            return value.get_type() == Variant::PACKED_VECTOR2_ARRAY && static_cast<size_t>(PackedVector2Array(value).size()) == vertex_count;
+    }
+}
+
+template <typename T>
+void copy_packed(T &dst, size_t offset, const Variant &value) {
+    const T src = value;
+    std::copy(src.ptr(), src.ptr() + src.size(), dst.ptrw() + offset);
+}
+
+struct MergeGroup {
+    Variant material;
+    std::vector<int> members;
+};
+
+// Monitors are polled by the debugger every frame, so each reads the counters directly
+Variant monitor_calls() { return static_cast<int64_t>(mesh_stats::get_stats().calls); }
+Variant monitor_triangles_in() { return static_cast<int64_t>(mesh_stats::get_stats().triangles_in); }
+Variant monitor_triangles_out() { return static_cast<int64_t>(mesh_stats::get_stats().triangles_out); }
+Variant monitor_kernel_msec() { return mesh_stats::get_stats().kernel_nsec / 1e6; }
+
+Variant monitor_convert_msec() {
+    mesh_stats::Stats stats = mesh_stats::get_stats();
+    return stats.total_nsec > stats.kernel_nsec ? (stats.total_nsec - stats.kernel_nsec) / 1e6 : 0.0;
+}
+
+Variant monitor_allocated_mb() {
+    mesh_arena::Stats allocator = mesh_arena::get_stats();
+    return (allocator.arena_bytes + allocator.heap_bytes) / (1024.0 * 1024.0);
+}
+
+struct PerformanceMonitor {
+    const char *id;
+    Variant (*value)();
+};
+
+const PerformanceMonitor PERFORMANCE_MONITORS[] = {
+    { "MeshOptimizer/calls", &monitor_calls },
+    { "MeshOptimizer/triangles_in", &monitor_triangles_in },
+    { "MeshOptimizer/triangles_out", &monitor_triangles_out },
+    { "MeshOptimizer/kernel_msec", &monitor_kernel_msec },
+    { "MeshOptimizer/convert_msec", &monitor_convert_msec },
+    { "MeshOptimizer/allocated_mb", &monitor_allocated_mb },
+};
+
+// View directions (object towards camera) for the view-bucketed index orders: the given
+// "view_directions", or a ring of "view_count" raised by "view_elevation" degrees
+PackedVector3Array view_directions(const Dictionary &options) {
+    PackedVector3Array directions = options.get("view_directions", PackedVector3Array());
+    if (directions.size() > 0) {
+        for (int64_t i = 0; i < directions.size(); i++) {
+            directions.set(i, directions[i].normalized());
+        }
+        return directions;
+    }
+
+    // The distant tiers are seen from around and slightly above, never from below
+    int count = CLAMP(static_cast<int>(options.get("view_count", 8)), 1, 64);
+    float elevation = static_cast<float>(options.get("view_elevation", 20.0f)) * static_cast<float>(Math_PI) / 180.0f;
+    for (int i = 0; i < count; i++) {
+        float angle = i * 2.0f * static_cast<float>(Math_PI) / count;
+        directions.push_back(Vector3(std::cos(elevation) * std::sin(angle), std::sin(elevation), std::cos(elevation) * std::cos(angle)));
+    }
+    return directions;
+}
+
+// One index buffer per direction with the same triangles ordered front to back. Triangles are
+// clustered into meshlets, which keeps the vertex cache behaviour inside a cluster, and clusters
+// are sorted by centroid depth along the direction
+Array view_ordered_indices(const PackedInt32Array &indices, const float *positions, size_t vertex_count, const PackedVector3Array &directions, size_t &r_cluster_count) {
+    const size_t max_vertices = 64;
+    const size_t max_triangles = 124;
+    size_t index_count = indices.size();
+
+    size_t max_meshlets = meshopt_buildMeshletsBound(index_count, max_vertices, max_triangles);
+    std::vector<meshopt_Meshlet> meshlets(max_meshlets);
+    std::vector<unsigned int> meshlet_vertices(max_meshlets * max_vertices);
+    std::vector<unsigned char> meshlet_triangles(max_meshlets * max_triangles * 3);
+
+    size_t meshlet_count = 0;
+    std::vector<unsigned int> clustered;
+    std::vector<size_t> offsets;
+    std::vector<float> centers;
+    {
+        mesh_stats::Kernel kernel;
+        meshlet_count = meshopt_buildMeshlets(
+            meshlets.data(), meshlet_vertices.data(), meshlet_triangles.data(),
+            index_stream(indices), index_count,
+            positions, vertex_count, float_stride<Vector3>(),
+            max_vertices, max_triangles, 0.0f
+        );
+
+        clustered.reserve(index_count);
+        offsets.resize(meshlet_count + 1);
+        centers.resize(meshlet_count * 3);
+        for (size_t m = 0; m < meshlet_count; m++) {
+            const meshopt_Meshlet &meshlet = meshlets[m];
+            unsigned int *local_vertices = &meshlet_vertices[meshlet.vertex_offset];
+            unsigned char *local_triangles = &meshlet_triangles[meshlet.triangle_offset];
+            meshopt_optimizeMeshlet(local_vertices, local_triangles, meshlet.triangle_count, meshlet.vertex_count);
+
+            offsets[m] = clustered.size();
+            float sum[3] = { 0.0f, 0.0f, 0.0f };
+            for (size_t i = 0; i < meshlet.triangle_count * 3; i++) {
+                unsigned int index = local_vertices[local_triangles[i]];
+                clustered.push_back(index);
+                for (int c = 0; c < 3; c++) {
+                    sum[c] += positions[index * 3 + c];
+                }
+            }
+            for (int c = 0; c < 3; c++) {
+                centers[m * 3 + c] = sum[c] / (meshlet.triangle_count * 3);
+            }
+        }
+        offsets[meshlet_count] = clustered.size();
+    }
+    r_cluster_count = meshlet_count;
+
+    Array orders;
+    std::vector<size_t> order(meshlet_count);
+    std::vector<float> depth(meshlet_count);
+    for (int64_t d = 0; d < directions.size(); d++) {
+        Vector3 direction = directions[d];
+        for (size_t m = 0; m < meshlet_count; m++) {
+            depth[m] = centers[m * 3 + 0] * direction.x + centers[m * 3 + 1] * direction.y + centers[m * 3 + 2] * direction.z;
+        }
+        // Nearest to the camera first, so later clusters fail the depth test instead of shading
+        std::iota(order.begin(), order.end(), size_t(0));
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return depth[a] > depth[b]; });
+
+        PackedInt32Array ordered;
+        ordered.resize(clustered.size());
+        int32_t *w = ordered.ptrw();
+        for (size_t m : order) {
+            for (size_t i = offsets[m]; i < offsets[m + 1]; i++) {
+                *w++ = static_cast<int32_t>(clustered[i]);
+            }
+        }
+        orders.push_back(ordered);
+    }
+
+    return orders;
+}
+
+// Cache key of an entry point call, 0 when the cache is off or the caller opted out
+uint64_t cache_key(const char *entry_point, const Dictionary &options, const Array &arguments) {
+    if (!mesh_cache::is_enabled() || !bool(options.get("cache", true))) {
+        return 0;
+    }
+    return mesh_cache::hash_call(entry_point, arguments);
+}
+
+} // namespace
+
+Array MeshOptimizerGD::simplify_mesh_arrays(const Array &mesh_arrays, float target_ratio, float target_error, const Dictionary &attribute_weights, bool compact_vertices, const Dictionary &options) {
+    uint64_t key = cache_key("simplify_mesh_arrays", options, Array::make(mesh_arrays, target_ratio, target_error, attribute_weights, compact_vertices, options));
+    Variant cached;
+    if (key && mesh_cache::lookup(key, cached)) {
+        return cached;
+    }
+
+    Array result = _simplify_mesh_arrays(mesh_arrays, target_ratio, target_error, attribute_weights, compact_vertices, options);
+    if (key && !result.is_empty()) {
+        mesh_cache::store(key, result);
+    }
+    return result;
+}
+
+Array MeshOptimizerGD::generate_lod_chain(const Array &mesh_arrays, const PackedFloat32Array &ratios, float target_error, const Dictionary &attribute_weights, const Dictionary &options) {
+    uint64_t key = cache_key("generate_lod_chain", options, Array::make(mesh_arrays, ratios, target_error, attribute_weights, options));
+    Variant cached;
+    if (key && mesh_cache::lookup(key, cached)) {
+        return cached;
+    }
+
+    Array result = _generate_lod_chain(mesh_arrays, ratios, target_error, attribute_weights, options);
+    if (key && !result.is_empty()) {
+        mesh_cache::store(key, result);
+    }
+    return result;
+}
+
+Array MeshOptimizerGD::generate_lod_chain_by_error(const Array &mesh_arrays, const PackedFloat32Array &world_errors, const Dictionary &attribute_weights, float min_ratio, const Dictionary &options) {
+    uint64_t key = cache_key("generate_lod_chain_by_error", options, Array::make(mesh_arrays, world_errors, attribute_weights, min_ratio, options));
+    Variant cached;
+    if (key && mesh_cache::lookup(key, cached)) {
+        return cached;
+    }
+
+    Array result = _generate_lod_chain_by_error(mesh_arrays, world_errors, attribute_weights, min_ratio, options);
+    if (key && !result.is_empty()) {
+        mesh_cache::store(key, result);
+    }
+    return result;
+}
+
+Array MeshOptimizerGD::merge_surfaces(const Array &surfaces, const Array &transforms, const Dictionary &params) {
+    uint64_t key = cache_key("merge_surfaces", params, Array::make(surfaces, transforms, params));
+    Variant cached;
+    if (key && mesh_cache::lookup(key, cached)) {
+        return cached;
+    }
+
+    Array result = _merge_surfaces(surfaces, transforms, params);
+    if (key && !result.is_empty()) {
+        mesh_cache::store(key, result);
+    }
+    return result;
+}
 
 void MeshOptimizerGD::_bind_methods() {
-    ClassDB::bind_method(D_METHOD("simplify", "vertices", "indices", "target_ratio", "target_error"),
-        &MeshOptimizerGD::simplify, DEFVAL(0.01f));
-    ClassDB::bind_method(D_METHOD("simplify_with_attributes", "vertices", "indices", "uvs", "target_ratio", "target_error", "uv_weight"),
-        &MeshOptimizerGD::simplify_with_attributes, DEFVAL(0.01f), DEFVAL(1.0f));
-    ClassDB::bind_method(D_METHOD("simplify_sloppy", "vertices", "indices", "target_ratio", "target_error"),
-        &MeshOptimizerGD::simplify_sloppy, DEFVAL(0.01f));
-    ClassDB::bind_method(D_METHOD("simplify_mesh_arrays", "mesh_arrays", "target_ratio", "target_error"),
-        &MeshOptimizerGD::simplify_mesh_arrays, DEFVAL(0.01f));
-    ClassDB::bind_method(D_METHOD("optimize_vertex_cache", "indices", "vertex_count"),
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("simplify", "vertices", "indices", "target_ratio", "target_error", "compact_vertices"),
+        &MeshOptimizerGD::simplify, DEFVAL(0.01f), DEFVAL(false));
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("simplify_with_attributes", "vertices", "indices", "uvs", "target_ratio", "target_error", "uv_weight", "compact_vertices", "vertex_lock", "simplify_flags"),
+        &MeshOptimizerGD::simplify_with_attributes, DEFVAL(0.01f), DEFVAL(1.0f), DEFVAL(false), DEFVAL(PackedByteArray()), DEFVAL(0));
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("simplify_sloppy", "vertices", "indices", "target_ratio", "target_error", "compact_vertices"),
+        &MeshOptimizerGD::simplify_sloppy, DEFVAL(0.01f), DEFVAL(false));
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("simplify_into", "vertices", "indices", "target_ratio", "target_error", "compact_vertices", "result"),
+        &MeshOptimizerGD::simplify_into);
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("simplify_with_attributes_into", "vertices", "indices", "uvs", "target_ratio", "target_error", "uv_weight", "compact_vertices", "vertex_lock", "simplify_flags", "result"),
+        &MeshOptimizerGD::simplify_with_attributes_into);
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("simplify_sloppy_into", "vertices", "indices", "target_ratio", "target_error", "compact_vertices", "result"),
+        &MeshOptimizerGD::simplify_sloppy_into);
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("simplify_points", "positions", "colors", "target_count", "color_weight"),
+        &MeshOptimizerGD::simplify_points, DEFVAL(1.0f));
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("spatial_sort_points", "positions"), &MeshOptimizerGD::spatial_sort_points);
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("spatial_sort_triangles", "mesh_arrays"), &MeshOptimizerGD::spatial_sort_triangles);
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("simplify_mesh_arrays", "mesh_arrays", "target_ratio", "target_error", "attribute_weights", "compact_vertices", "options"),
+        &MeshOptimizerGD::simplify_mesh_arrays, DEFVAL(0.01f), DEFVAL(Dictionary()), DEFVAL(true), DEFVAL(Dictionary()));
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("generate_lod_chain", "mesh_arrays", "ratios", "target_error", "attribute_weights", "options"),
+        &MeshOptimizerGD::generate_lod_chain, DEFVAL(0.01f), DEFVAL(Dictionary()), DEFVAL(Dictionary()));
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("optimize_vertex_cache", "indices", "vertex_count"),
         &MeshOptimizerGD::optimize_vertex_cache);
-    ClassDB::bind_method(D_METHOD("weld_vertices", "vertices", "indices", "threshold"),
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("weld_vertices", "vertices", "indices", "threshold"),
         &MeshOptimizerGD::weld_vertices, DEFVAL(0.0001f));
-    ClassDB::bind_method(D_METHOD("get_version"), &MeshOptimizerGD::get_version);
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("weld_vertices_into", "vertices", "indices", "threshold", "result"),
+        &MeshOptimizerGD::weld_vertices_into);
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("optimize_surface", "mesh_arrays", "flags", "overdraw_threshold"),
+        &MeshOptimizerGD::optimize_surface, DEFVAL(OPTIMIZE_ALL), DEFVAL(1.05f));
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("build_meshlets", "mesh_arrays", "max_vertices", "max_triangles", "cone_weight"),
+        &MeshOptimizerGD::build_meshlets, DEFVAL(64), DEFVAL(124), DEFVAL(0.25f));
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("encode_surface", "mesh_arrays", "options"),
+        &MeshOptimizerGD::encode_surface, DEFVAL(Dictionary()));
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("encode_surfaces", "surfaces", "options"),
+        &MeshOptimizerGD::encode_surfaces, DEFVAL(Dictionary()));
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("decode_surface", "data", "surface_index"),
+        &MeshOptimizerGD::decode_surface, DEFVAL(0));
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("decode_surfaces", "data"), &MeshOptimizerGD::decode_surfaces);
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("get_encoded_surface_count", "data"), &MeshOptimizerGD::get_encoded_surface_count);
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("encode_progressive", "mesh_arrays", "ratios", "options"),
+        &MeshOptimizerGD::encode_progressive, DEFVAL(PackedFloat32Array()), DEFVAL(Dictionary()));
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("get_progressive_info", "data"), &MeshOptimizerGD::get_progressive_info);
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("decode_progressive", "data", "level"),
+        &MeshOptimizerGD::decode_progressive, DEFVAL(-1));
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("build_surface_data", "mesh_arrays", "lods", "primitive"),
+        &MeshOptimizerGD::build_surface_data, DEFVAL(Array()), DEFVAL(Mesh::PRIMITIVE_TRIANGLES));
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("quantize_surface", "mesh_arrays", "options"),
+        &MeshOptimizerGD::quantize_surface, DEFVAL(Dictionary()));
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("analyze_surface", "mesh_arrays", "cache_size"),
+        &MeshOptimizerGD::analyze_surface, DEFVAL(16));
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("analyze_directory", "path", "report_path", "thresholds"),
+        &MeshOptimizerGD::analyze_directory, DEFVAL(""), DEFVAL(Dictionary()));
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("merge_surfaces", "surfaces", "transforms", "params"),
+        &MeshOptimizerGD::merge_surfaces, DEFVAL(Dictionary()));
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("get_allocator_stats"), &MeshOptimizerGD::get_allocator_stats);
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("reset_allocator_stats"), &MeshOptimizerGD::reset_allocator_stats);
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("get_peak_memory_usage"), &MeshOptimizerGD::get_peak_memory_usage);
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("get_stats"), &MeshOptimizerGD::get_stats);
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("reset_stats"), &MeshOptimizerGD::reset_stats);
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("generate_lod_chain_by_error", "mesh_arrays", "world_errors", "attribute_weights", "min_ratio", "options"),
+        &MeshOptimizerGD::generate_lod_chain_by_error, DEFVAL(Dictionary()), DEFVAL(0.0f), DEFVAL(Dictionary()));
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("get_simplify_scale", "vertices"), &MeshOptimizerGD::get_simplify_scale);
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("get_lod_switch_distance", "world_error", "viewport_height", "fov_degrees", "pixel_error"),
+        &MeshOptimizerGD::get_lod_switch_distance, DEFVAL(75.0f), DEFVAL(1.0f));
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("generate_shadow_indices", "mesh_arrays", "position_only"),
+        &MeshOptimizerGD::generate_shadow_indices, DEFVAL(true));
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("build_impostor_cards", "mesh_arrays", "options"),
+        &MeshOptimizerGD::build_impostor_cards, DEFVAL(Dictionary()));
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("build_view_orders", "mesh_arrays", "options"),
+        &MeshOptimizerGD::build_view_orders, DEFVAL(Dictionary()));
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("select_view_order", "directions", "to_camera"), &MeshOptimizerGD::select_view_order);
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("build_collision_proxy", "mesh_arrays", "max_triangles", "target_error", "options"),
+        &MeshOptimizerGD::build_collision_proxy, DEFVAL(256), DEFVAL(0.01f), DEFVAL(Dictionary()));
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("configure_cache", "max_bytes", "directory"),
+        &MeshOptimizerGD::configure_cache, DEFVAL(""));
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("clear_cache"), &MeshOptimizerGD::clear_cache);
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("get_cache_stats"), &MeshOptimizerGD::get_cache_stats);
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("pack_indices16", "indices"), &MeshOptimizerGD::pack_indices16);
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("unpack_indices16", "data"), &MeshOptimizerGD::unpack_indices16);
+    ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("get_version"), &MeshOptimizerGD::get_version);
     ClassDB::bind_static_method("MeshOptimizerGD", D_METHOD("is_available"), &MeshOptimizerGD::is_available);
+
+    BIND_ENUM_CONSTANT(OPTIMIZE_WELD);
+    BIND_ENUM_CONSTANT(OPTIMIZE_VERTEX_CACHE);
+    BIND_ENUM_CONSTANT(OPTIMIZE_OVERDRAW);
+    BIND_ENUM_CONSTANT(OPTIMIZE_VERTEX_FETCH);
+    BIND_ENUM_CONSTANT(OPTIMIZE_ALL);
+
+    BIND_ENUM_CONSTANT(SIMPLIFY_LOCK_BORDER);
+    BIND_ENUM_CONSTANT(SIMPLIFY_SPARSE);
+    BIND_ENUM_CONSTANT(SIMPLIFY_ERROR_ABSOLUTE);
 }
 
 MeshOptimizerGD::MeshOptimizerGD() {}
 MeshOptimizerGD::~MeshOptimizerGD() {}
 
 Dictionary MeshOptimizerGD::simplify(
-    PackedVector3Array vertices,
-    PackedInt32Array indices,
+    const PackedVector3Array &vertices,
+    const PackedInt32Array &indices,
+    float target_ratio,
+    float target_error,
+    bool compact_vertices
+) {
+    Ref<MeshOptimizerResult> result;
+    result.instantiate();
+    simplify_into(vertices, indices, target_ratio, target_error, compact_vertices, result);
+    return result->to_dictionary();
+}
+
+bool MeshOptimizerGD::simplify_into(
+    const PackedVector3Array &vertices,
+    const PackedInt32Array &indices,
+    float target_ratio,
+    float target_error,
+    bool compact_vertices,
+    const Ref<MeshOptimizerResult> &result
+) {
+    mesh_stats::Call call;
+
+    if (result.is_null()) {
+        UtilityFunctions::push_error("MeshOptimizerGD: simplify_into needs a MeshOptimizerResult");
+        return false;
+    }
+    result->_begin(MeshOptimizerResult::SOURCE_SIMPLIFY);
+
+    if (vertices.size() == 0 || indices.size() == 0) {
+        return result->_fail("Empty input");
+    }
+
+    // Hold our own references, the inputs may be the result's buffers from a previous call
+    const PackedVector3Array source_vertices = vertices;
+    const PackedInt32Array source_indices = indices;
+
+    size_t vertex_count = source_vertices.size();
+    size_t index_count = source_indices.size();
+    size_t target_index_count = static_cast<size_t>(index_count * target_ratio);
+
+    // Ensure minimum
+    if (target_index_count < 3) target_index_count = 3;
+
+    std::vector<float> position_scratch;
+    const float *positions = float_stream(source_vertices.ptr(), vertex_count, position_scratch);
+
+    // Output buffer (worst case is index_count), trimmed after simplification
+    PackedInt32Array &new_indices = result->indices;
+    new_indices.resize(index_count);
+    float result_error = 0.0f;
+
+    // Run simplification
+    size_t new_index_count = 0;
+    uint64_t kernel_start = now_usec();
+    {
+        mesh_stats::Kernel kernel;
+        new_index_count = meshopt_simplify(
+            index_stream_w(new_indices),
+            index_stream(source_indices),
+            index_count,
+            positions,
+            vertex_count,
+            float_stride<Vector3>(),
+            target_index_count,
+            target_error,
+            0, // options
+            &result_error
+        );
+    }
+    new_indices.resize(new_index_count);
+    call.triangles(index_count / 3, new_index_count / 3);
+
+    // Compaction is meshopt work as well, so kernel_usec runs until it is done
+    if (compact_vertices) {
+        size_t unique_count = build_fetch_remap_into(result->remap, new_indices, vertex_count);
+        {
+            mesh_stats::Kernel kernel;
+            meshopt_remapIndexBuffer(index_stream_w(new_indices), index_stream(new_indices), new_index_count, index_stream(result->remap));
+        }
+        remap_packed_into(result->vertices, source_vertices, vertex_count, unique_count, result->remap);
+        result->has_remap = true;
+    } else {
+        result->vertices = source_vertices; // Vertices unchanged, just reindexed
+    }
+    result->kernel_usec = static_cast<int64_t>(now_usec() - kernel_start);
+    result->result_error = result_error;
+    result->original_triangles = static_cast<int>(index_count / 3);
+    result->simplified_triangles = static_cast<int>(new_index_count / 3);
+    result->original_vertex_count = static_cast<int>(vertex_count);
+    result->vertex_count = result->vertices.size();
+
+    return true;
+}
+
+Dictionary MeshOptimizerGD::simplify_with_attributes(
+    const PackedVector3Array &vertices,
+    const PackedInt32Array &indices,
+    const PackedVector2Array &uvs,
     float target_ratio,
-    float target_error
+    float target_error,
+    float uv_weight,
+    bool compact_vertices,
+    const PackedByteArray &vertex_lock,
+    int simplify_flags
+) {
+    Ref<MeshOptimizerResult> result;
+    result.instantiate();
+    simplify_with_attributes_into(vertices, indices, uvs, target_ratio, target_error, uv_weight, compact_vertices, vertex_lock, simplify_flags, result);
+    return result->to_dictionary();
+}
+
+bool MeshOptimizerGD::simplify_with_attributes_into(
+    const PackedVector3Array &vertices,
+    const PackedInt32Array &indices,
+    const PackedVector2Array &uvs,
+    float target_ratio,
+    float target_error,
+    float uv_weight,
+    bool compact_vertices,
+    const PackedByteArray &vertex_lock,
+    int simplify_flags,
+    const Ref<MeshOptimizerResult> &result
 ) {
+    mesh_stats::Call call;
+
+    if (result.is_null()) {
+        UtilityFunctions::push_error("MeshOptimizerGD: simplify_with_attributes_into needs a MeshOptimizerResult");
+        return false;
+    }
+    result->_begin(MeshOptimizerResult::SOURCE_SIMPLIFY);
+
+    if (vertices.size() == 0 || indices.size() == 0) {
+        return result->_fail("Empty input");
+    }
+
+    if (vertex_lock.size() > 0 && vertex_lock.size() != vertices.size()) {
+        return result->_fail("vertex_lock size does not match the vertex count");
+    }
+
+    // Without matching UVs there is nothing to weigh, fall back to regular simplification
+    if (uvs.size() != vertices.size() && vertex_lock.size() == 0 && simplify_flags == 0) {
+        return simplify_into(vertices, indices, target_ratio, target_error, compact_vertices, result);
+    }
+    bool has_uvs = uvs.size() == vertices.size();
+
+    const PackedVector3Array source_vertices = vertices;
+    const PackedInt32Array source_indices = indices;
+    const PackedVector2Array source_uvs = uvs;
+
+    size_t vertex_count = source_vertices.size();
+    size_t index_count = source_indices.size();
+    size_t target_index_count = static_cast<size_t>(index_count * target_ratio);
+
+    if (target_index_count < 3) target_index_count = 3;
+
+    std::vector<float> position_scratch;
+    std::vector<float> uv_scratch;
+    const float *positions = float_stream(source_vertices.ptr(), vertex_count, position_scratch);
+    const float *uv_data = has_uvs ? float_stream(source_uvs.ptr(), vertex_count, uv_scratch) : nullptr;
+
+    // Output buffer
+    PackedInt32Array &new_indices = result->indices;
+    new_indices.resize(index_count);
+    float result_error = 0.0f;
+
+    float attribute_weights[2] = { uv_weight, uv_weight };
+
+    size_t new_index_count = 0;
+    uint64_t kernel_start = now_usec();
+    {
+        mesh_stats::Kernel kernel;
+        new_index_count = meshopt_simplifyWithAttributes(
+            index_stream_w(new_indices),
+            index_stream(source_indices),
+            index_count,
+            positions,
+            vertex_count,
+            float_stride<Vector3>(),
+            uv_data,
+            has_uvs ? float_stride<Vector2>() : 0,
+            has_uvs ? attribute_weights : nullptr,
+            has_uvs ? 2 : 0, // attribute count (u, v)
+            vertex_lock.size() > 0 ? vertex_lock.ptr() : nullptr,
+            target_index_count,
+            target_error,
+            static_cast<unsigned int>(simplify_flags) & (meshopt_SimplifyLockBorder | meshopt_SimplifySparse | meshopt_SimplifyErrorAbsolute),
+            &result_error
+        );
+    }
+    new_indices.resize(new_index_count);
+    call.triangles(index_count / 3, new_index_count / 3);
+
+    if (compact_vertices) {
+        size_t unique_count = build_fetch_remap_into(result->remap, new_indices, vertex_count);
+        {
+            mesh_stats::Kernel kernel;
+            meshopt_remapIndexBuffer(index_stream_w(new_indices), index_stream(new_indices), new_index_count, index_stream(result->remap));
+        }
+        remap_packed_into(result->vertices, source_vertices, vertex_count, unique_count, result->remap);
+        if (has_uvs) {
+            remap_packed_into(result->uvs, source_uvs, vertex_count, unique_count, result->remap);
+        }
+        result->has_remap = true;
+    } else {
+        result->vertices = source_vertices;
+        if (has_uvs) {
+            result->uvs = source_uvs;
+        }
+    }
+    result->kernel_usec = static_cast<int64_t>(now_usec() - kernel_start);
+    result->has_uvs = has_uvs;
+    result->result_error = result_error;
+    result->original_triangles = static_cast<int>(index_count / 3);
+    result->simplified_triangles = static_cast<int>(new_index_count / 3);
+    result->original_vertex_count = static_cast<int>(vertex_count);
+    result->vertex_count = result->vertices.size();
+
+    return true;
+}
+
+Dictionary MeshOptimizerGD::simplify_sloppy(
+    const PackedVector3Array &vertices,
+    const PackedInt32Array &indices,
+    float target_ratio,
+    float target_error,
+    bool compact_vertices
+) {
+    Ref<MeshOptimizerResult> result;
+    result.instantiate();
+    simplify_sloppy_into(vertices, indices, target_ratio, target_error, compact_vertices, result);
+    return result->to_dictionary();
+}
+
+bool MeshOptimizerGD::simplify_sloppy_into(
+    const PackedVector3Array &vertices,
+    const PackedInt32Array &indices,
+    float target_ratio,
+    float target_error,
+    bool compact_vertices,
+    const Ref<MeshOptimizerResult> &result
+) {
+    mesh_stats::Call call;
+
+    if (result.is_null()) {
+        UtilityFunctions::push_error("MeshOptimizerGD: simplify_sloppy_into needs a MeshOptimizerResult");
+        return false;
+    }
+    result->_begin(MeshOptimizerResult::SOURCE_SIMPLIFY);
+
+    if (vertices.size() == 0 || indices.size() == 0) {
+        return result->_fail("Empty input");
+    }
+
+    const PackedVector3Array source_vertices = vertices;
+    const PackedInt32Array source_indices = indices;
+
+    size_t vertex_count = source_vertices.size();
+    size_t index_count = source_indices.size();
+    size_t target_index_count = static_cast<size_t>(index_count * target_ratio);
+
+    if (target_index_count < 3) target_index_count = 3;
+
+    std::vector<float> position_scratch;
+    const float *positions = float_stream(source_vertices.ptr(), vertex_count, position_scratch);
+
+    // Output buffer
+    PackedInt32Array &new_indices = result->indices;
+    new_indices.resize(index_count);
+    float result_error = 0.0f;
+
+    // Run sloppy simplification (faster, ignores topology)
+    size_t new_index_count = 0;
+    uint64_t kernel_start = now_usec();
+    {
+        mesh_stats::Kernel kernel;
+        new_index_count = meshopt_simplifySloppy(
+            index_stream_w(new_indices),
+            index_stream(source_indices),
+            index_count,
+            positions,
+            vertex_count,
+            float_stride<Vector3>(),
+            target_index_count,
+            target_error,
+            &result_error
+        );
+    }
+    new_indices.resize(new_index_count);
+    call.triangles(index_count / 3, new_index_count / 3);
+
+    if (compact_vertices) {
+        size_t unique_count = build_fetch_remap_into(result->remap, new_indices, vertex_count);
+        {
+            mesh_stats::Kernel kernel;
+            meshopt_remapIndexBuffer(index_stream_w(new_indices), index_stream(new_indices), new_index_count, index_stream(result->remap));
+        }
+        remap_packed_into(result->vertices, source_vertices, vertex_count, unique_count, result->remap);
+        result->has_remap = true;
+    } else {
+        result->vertices = source_vertices;
+    }
+    result->kernel_usec = static_cast<int64_t>(now_usec() - kernel_start);
+    result->result_error = result_error;
+    result->original_triangles = static_cast<int>(index_count / 3);
+    result->simplified_triangles = static_cast<int>(new_index_count / 3);
+    result->original_vertex_count = static_cast<int>(vertex_count);
+    result->vertex_count = result->vertices.size();
+
+    return true;
+}
+
+Dictionary MeshOptimizerGD::simplify_points(const PackedVector3Array &positions, const PackedColorArray &colors, int target_count, float color_weight) {
+    mesh_stats::Call call;
+
+    Dictionary result;
+
+    if (positions.size() == 0) {
+        result["error"] = "Empty input";
+        return result;
+    }
+
+    if (colors.size() > 0 && colors.size() != positions.size()) {
+        result["error"] = "Colors size does not match positions";
+        return result;
+    }
+
+    size_t point_count = positions.size();
+    size_t target = static_cast<size_t>(CLAMP(target_count, 0, static_cast<int>(point_count)));
+
+    std::vector<float> position_scratch;
+    const float *position_data = float_stream(positions.ptr(), point_count, position_scratch);
+
+    // Color is float RGBA regardless of real_t; the simplifier reads the first three channels
+    const float *color_data = colors.size() > 0 ? reinterpret_cast<const float *>(colors.ptr()) : nullptr;
+
+    PackedInt32Array kept;
+    kept.resize(target);
+    size_t kept_count = 0;
+    if (target > 0) {
+        mesh_stats::Kernel kernel;
+        kept_count = meshopt_simplifyPoints(
+            index_stream_w(kept),
+            position_data,
+            point_count,
+            float_stride<Vector3>(),
+            color_data,
+            color_data ? sizeof(Color) : 0,
+            color_weight,
+            target
+        );
+    }
+    kept.resize(kept_count);
+
+    PackedVector3Array kept_positions;
+    kept_positions.resize(kept_count);
+    Vector3 *wp = kept_positions.ptrw();
+    for (size_t i = 0; i < kept_count; i++) {
+        wp[i] = positions[kept[i]];
+    }
+
+    result["indices"] = kept;
+    result["positions"] = kept_positions;
+    if (colors.size() > 0) {
+        PackedColorArray kept_colors;
+        kept_colors.resize(kept_count);
+        Color *wc = kept_colors.ptrw();
+        for (size_t i = 0; i < kept_count; i++) {
+            wc[i] = colors[kept[i]];
+        }
+        result["colors"] = kept_colors;
+    }
+
+    return result;
+}
+
+PackedInt32Array MeshOptimizerGD::spatial_sort_points(const PackedVector3Array &positions) {
+    mesh_stats::Call call;
+    PackedInt32Array remap;
+    size_t point_count = positions.size();
+    if (point_count == 0) {
+        return remap;
+    }
+
+    std::vector<float> position_scratch;
+    const float *position_data = float_stream(positions.ptr(), point_count, position_scratch);
+
+    remap.resize(point_count);
+    mesh_stats::Kernel kernel;
+    meshopt_spatialSortRemap(index_stream_w(remap), position_data, point_count, float_stride<Vector3>());
+
+    return remap;
+}
+
+Array MeshOptimizerGD::spatial_sort_triangles(const Array &mesh_arrays) {
+    mesh_stats::Call call;
+
+    Array result;
+
+    if (mesh_arrays.size() < Mesh::ARRAY_MAX) {
+        UtilityFunctions::push_error("MeshOptimizerGD: Invalid mesh arrays size");
+        return result;
+    }
+
+    Variant v_vertices = mesh_arrays[Mesh::ARRAY_VERTEX];
+    if (v_vertices.get_type() != Variant::PACKED_VECTOR3_ARRAY) {
+        UtilityFunctions::push_error("MeshOptimizerGD: Missing vertices");
+        return result;
+    }
+
+    const PackedVector3Array vertices = v_vertices;
+    size_t vertex_count = vertices.size();
+    if (vertex_count == 0) {
+        return mesh_arrays;
+    }
+
+    PackedInt32Array indices = surface_indices(mesh_arrays[Mesh::ARRAY_INDEX], vertex_count);
+    if (!valid_triangle_indices(indices, vertex_count)) {
+        UtilityFunctions::push_error("MeshOptimizerGD: Indices out of range or not a triangle list");
+        return result;
+    }
+
+    std::vector<float> position_scratch;
+    const float *positions = float_stream(vertices.ptr(), vertex_count, position_scratch);
+
+    // In place; the sorter keeps its own copy of the source indices for that case
+    {
+        mesh_stats::Kernel kernel;
+        meshopt_spatialSortTriangles(index_stream_w(indices), index_stream(indices), indices.size(), positions, vertex_count, float_stride<Vector3>());
+    }
+    call.triangles(indices.size() / 3, indices.size() / 3);
+
+    result = mesh_arrays.duplicate();
+    result[Mesh::ARRAY_INDEX] = indices;
+    return result;
+}
+
+Array MeshOptimizerGD::_simplify_mesh_arrays(const Array &mesh_arrays, float target_ratio, float target_error, const Dictionary &attribute_weights, bool compact_vertices, const Dictionary &options) {
+    mesh_stats::Call call;
+
+    Array result;
+
+    if (mesh_arrays.size() < Mesh::ARRAY_MAX) {
+        UtilityFunctions::push_error("MeshOptimizerGD: Invalid mesh arrays size");
+        return result;
+    }
+
+    Variant v_vertices = mesh_arrays[Mesh::ARRAY_VERTEX];
+    Variant v_indices = mesh_arrays[Mesh::ARRAY_INDEX];
+
+    if (v_vertices.get_type() != Variant::PACKED_VECTOR3_ARRAY ||
+        v_indices.get_type() != Variant::PACKED_INT32_ARRAY) {
+        UtilityFunctions::push_error("MeshOptimizerGD: Missing vertices or indices");
+        return result;
+    }
+
+    const PackedVector3Array vertices = v_vertices;
+    const PackedInt32Array indices = v_indices;
+
+    if (vertices.size() == 0 || indices.size() == 0) {
+        return mesh_arrays; // Return original if empty
+    }
+
+    size_t vertex_count = vertices.size();
+    size_t index_count = indices.size();
+    size_t target_index_count = static_cast<size_t>(index_count * target_ratio);
+
+    if (target_index_count < 3) target_index_count = 3;
+
+    std::vector<float> position_scratch;
+    const float *positions = float_stream(vertices.ptr(), vertex_count, position_scratch);
+
+    AttributeStream attributes;
+    build_attribute_stream(mesh_arrays, vertex_count, attribute_weights, attributes);
+
+    SimplifyOptions simplify_options;
+    build_simplify_options(options, positions, vertex_count, simplify_options);
+
+    PackedInt32Array new_indices;
+    new_indices.resize(index_count);
+    size_t new_index_count = simplify_indices(
+        index_stream_w(new_indices),
+        index_stream(indices),
+        index_count,
+        positions,
+        vertex_count,
+        attributes,
+        target_index_count,
+        target_error,
+        simplify_options,
+        nullptr
+    );
+    new_indices.resize(new_index_count);
+    call.triangles(index_count / 3, new_index_count / 3);
+
+    if (compact_vertices) {
+        return compact_surface(mesh_arrays, new_indices, vertex_count);
+    }
+
+    // Vertices are unchanged and just reindexed, so every other array carries over as is
+    result = mesh_arrays.duplicate();
+    result[Mesh::ARRAY_INDEX] = new_indices;
+
+    return result;
+}
+
+Array MeshOptimizerGD::_generate_lod_chain(const Array &mesh_arrays, const PackedFloat32Array &ratios, float target_error, const Dictionary &attribute_weights, const Dictionary &options) {
+    mesh_stats::Call call;
+
+    Array result;
+
+    if (mesh_arrays.size() < Mesh::ARRAY_MAX) {
+        UtilityFunctions::push_error("MeshOptimizerGD: Invalid mesh arrays size");
+        return result;
+    }
+
+    Variant v_vertices = mesh_arrays[Mesh::ARRAY_VERTEX];
+    Variant v_indices = mesh_arrays[Mesh::ARRAY_INDEX];
+
+    if (v_vertices.get_type() != Variant::PACKED_VECTOR3_ARRAY ||
+        v_indices.get_type() != Variant::PACKED_INT32_ARRAY) {
+        UtilityFunctions::push_error("MeshOptimizerGD: Missing vertices or indices");
+        return result;
+    }
+
+    const PackedVector3Array vertices = v_vertices;
+    const PackedInt32Array indices = v_indices;
+
+    if (vertices.size() == 0 || indices.size() == 0 || ratios.size() == 0) {
+        return result;
+    }
+
+    size_t vertex_count = vertices.size();
+    size_t index_count = indices.size();
+
+    // Convert once, every level reads the same streams
+    std::vector<float> position_scratch;
+    const float *positions = float_stream(vertices.ptr(), vertex_count, position_scratch);
+
+    AttributeStream attributes;
+    build_attribute_stream(mesh_arrays, vertex_count, attribute_weights, attributes);
+
+    SimplifyOptions simplify_options;
+    build_simplify_options(options, positions, vertex_count, simplify_options);
+
+    // Absolute errors already are in mesh units
+    float scale = (simplify_options.flags & meshopt_SimplifyErrorAbsolute) ? 1.0f : meshopt_simplifyScale(positions, vertex_count, float_stride<Vector3>());
+
+    // Each level starts from the previous one, so work shrinks as the chain goes on
+    PackedInt32Array source = indices;
+    float accumulated_error = 0.0f;
+    size_t lod_index_total = 0;
+
+    for (int64_t level = 0; level < ratios.size(); level++) {
+        float ratio = ratios[level];
+        size_t source_count = source.size();
+        size_t target_index_count = static_cast<size_t>(index_count * CLAMP(ratio, 0.0f, 1.0f));
+
+        if (target_index_count < 3) target_index_count = 3;
+        // Ratios are of the input but levels start from the previous one, which the simplifier
+        // cannot grow (ratios out of order, above 1, or a level that already collapsed)
+        target_index_count = MIN(target_index_count, source_count);
+
+        PackedInt32Array lod_indices = source;
+        size_t new_index_count = source_count;
+        float result_error = 0.0f;
+        if (source_count >= 3) {
+            lod_indices.resize(source_count);
+            new_index_count = simplify_indices(
+                index_stream_w(lod_indices),
+                index_stream(source),
+                source_count,
+                positions,
+                vertex_count,
+                attributes,
+                target_index_count,
+                target_error,
+                simplify_options,
+                &result_error
+            );
+            lod_indices.resize(new_index_count);
+        }
+        lod_index_total += new_index_count;
+
+        // Errors are relative to the previous level; summing keeps a conservative bound vs the input
+        accumulated_error += result_error;
+
+        Dictionary lod;
+        lod["indices"] = lod_indices;
+        lod["result_error"] = accumulated_error;
+        lod["world_error"] = accumulated_error * scale;
+        lod["ratio"] = ratio;
+        lod["triangles"] = static_cast<int>(new_index_count / 3);
+        result.push_back(lod);
+
+        source = lod_indices;
+    }
+    call.triangles(index_count / 3, lod_index_total / 3);
+
+    return result;
+}
+
+Array MeshOptimizerGD::_generate_lod_chain_by_error(const Array &mesh_arrays, const PackedFloat32Array &world_errors, const Dictionary &attribute_weights, float min_ratio, const Dictionary &options) {
+    mesh_stats::Call call;
+
+    Array result;
+
+    if (mesh_arrays.size() < Mesh::ARRAY_MAX) {
+        UtilityFunctions::push_error("MeshOptimizerGD: Invalid mesh arrays size");
+        return result;
+    }
+
+    Variant v_vertices = mesh_arrays[Mesh::ARRAY_VERTEX];
+    Variant v_indices = mesh_arrays[Mesh::ARRAY_INDEX];
+
+    if (v_vertices.get_type() != Variant::PACKED_VECTOR3_ARRAY ||
+        v_indices.get_type() != Variant::PACKED_INT32_ARRAY) {
+        UtilityFunctions::push_error("MeshOptimizerGD: Missing vertices or indices");
+        return result;
+    }
+
+    const PackedVector3Array vertices = v_vertices;
+    const PackedInt32Array indices = v_indices;
+
+    if (vertices.size() == 0 || indices.size() == 0 || world_errors.size() == 0) {
+        return result;
+    }
+
+    size_t vertex_count = vertices.size();
+    size_t index_count = indices.size();
+
+    std::vector<float> position_scratch;
+    const float *positions = float_stream(vertices.ptr(), vertex_count, position_scratch);
+
+    AttributeStream attributes;
+    build_attribute_stream(mesh_arrays, vertex_count, attribute_weights, attributes);
+
+    // Budgets are converted to relative errors here, so an absolute flag would double-convert
+    SimplifyOptions simplify_options;
+    build_simplify_options(options, positions, vertex_count, simplify_options);
+    simplify_options.flags &= ~meshopt_SimplifyErrorAbsolute;
+
+    float scale = meshopt_simplifyScale(positions, vertex_count, float_stride<Vector3>());
+    if (scale <= 0.0f) {
+        return result; // Degenerate mesh, every vertex in one place
+    }
+
+    size_t min_index_count = static_cast<size_t>(index_count * CLAMP(min_ratio, 0.0f, 1.0f)) / 3 * 3;
+    size_t lod_index_total = 0;
+
+    for (int64_t level = 0; level < world_errors.size(); level++) {
+        float world_error = world_errors[level];
+
+        PackedInt32Array lod_indices;
+        lod_indices.resize(index_count);
+        float result_error = 0.0f;
+        size_t new_index_count = simplify_indices(
+            index_stream_w(lod_indices),
+            index_stream(indices),
+            index_count,
+            positions,
+            vertex_count,
+            attributes,
+            min_index_count,
+            MAX(world_error, 0.0f) / scale,
+            simplify_options,
+            &result_error
+        );
+        lod_indices.resize(new_index_count);
+        lod_index_total += new_index_count;
+
+        Dictionary lod;
+        lod["indices"] = lod_indices;
+        lod["result_error"] = result_error;
+        lod["world_error"] = result_error * scale;
+        lod["ratio"] = static_cast<float>(new_index_count) / index_count;
+        lod["triangles"] = static_cast<int>(new_index_count / 3);
+        result.push_back(lod);
+    }
+    call.triangles(index_count / 3, lod_index_total / 3);
+
+    return result;
+}
+
+float MeshOptimizerGD::get_simplify_scale(const PackedVector3Array &vertices) {
+    if (vertices.size() == 0) {
+        return 0.0f;
+    }
+
+    std::vector<float> position_scratch;
+    const float *positions = float_stream(vertices.ptr(), vertices.size(), position_scratch);
+    return meshopt_simplifyScale(positions, vertices.size(), float_stride<Vector3>());
+}
+
+float MeshOptimizerGD::get_lod_switch_distance(float world_error, float viewport_height, float fov_degrees, float pixel_error) {
+    if (world_error <= 0.0f || viewport_height <= 0.0f || pixel_error <= 0.0f) {
+        return 0.0f;
+    }
+
+    // A length l at distance d covers l * viewport_height / (2 * d * tan(fov / 2)) pixels
+    float half_fov_tan = std::tan(CLAMP(fov_degrees, 1.0f, 179.0f) * static_cast<float>(Math_PI) / 360.0f);
+    return world_error * viewport_height / (2.0f * half_fov_tan * pixel_error);
+}
+
+PackedInt32Array MeshOptimizerGD::optimize_vertex_cache(const PackedInt32Array &indices, int vertex_count) {
+    mesh_stats::Call call;
+
+    if (indices.size() == 0 || vertex_count <= 0) {
+        return indices;
+    }
+
+    size_t index_count = indices.size();
+
+    PackedInt32Array result;
+    result.resize(index_count);
+    {
+        mesh_stats::Kernel kernel;
+        meshopt_optimizeVertexCache(
+            index_stream_w(result),
+            index_stream(indices),
+            index_count,
+            static_cast<size_t>(vertex_count)
+        );
+    }
+    call.triangles(index_count / 3, index_count / 3);
+
+    return result;
+}
+
+Dictionary MeshOptimizerGD::weld_vertices(
+    const PackedVector3Array &vertices,
+    const PackedInt32Array &indices,
+    float threshold
+) {
+    Ref<MeshOptimizerResult> result;
+    result.instantiate();
+    weld_vertices_into(vertices, indices, threshold, result);
+    return result->to_dictionary();
+}
+
+bool MeshOptimizerGD::weld_vertices_into(
+    const PackedVector3Array &vertices,
+    const PackedInt32Array &indices,
+    float threshold,
+    const Ref<MeshOptimizerResult> &result
+) {
+    mesh_stats::Call call;
+
+    if (result.is_null()) {
+        UtilityFunctions::push_error("MeshOptimizerGD: weld_vertices_into needs a MeshOptimizerResult");
+        return false;
+    }
+    result->_begin(MeshOptimizerResult::SOURCE_WELD);
+
+    if (vertices.size() == 0) {
+        return result->_fail("Empty vertices");
+    }
+
+    const PackedVector3Array source_vertices = vertices;
+    const PackedInt32Array source_indices = indices;
+
+    size_t vertex_count = source_vertices.size();
+    size_t index_count = source_indices.size();
+
+    // Remap and vertex buffer copies are byte-wise, so the packed Vector3 memory is used as is
+    // The remap buffer is reused across calls but not exposed, welding has no compaction remap
+    PackedInt32Array &remap = result->remap;
+    remap.resize(vertex_count);
+    size_t unique_count = 0;
+    uint64_t kernel_start = now_usec();
+    {
+        mesh_stats::Kernel kernel;
+        unique_count = meshopt_generateVertexRemap(
+            index_stream_w(remap),
+            index_count > 0 ? index_stream(source_indices) : nullptr,
+            index_count > 0 ? index_count : vertex_count,
+            source_vertices.ptr(),
+            vertex_count,
+            sizeof(Vector3)
+        );
+    }
+
+    // Apply remap to create new vertex buffer
+    remap_packed_into(result->vertices, source_vertices, vertex_count, unique_count, remap);
+
+    // Remap indices if provided
+    PackedInt32Array &new_indices = result->indices;
+    new_indices.resize(index_count);
+    if (index_count > 0) {
+        mesh_stats::Kernel kernel;
+        meshopt_remapIndexBuffer(index_stream_w(new_indices), index_stream(source_indices), index_count, index_stream(remap));
+    }
+    result->kernel_usec = static_cast<int64_t>(now_usec() - kernel_start);
+
+    result->original_vertex_count = static_cast<int>(vertex_count);
+    result->vertex_count = static_cast<int>(unique_count);
+    call.triangles(index_count / 3, index_count / 3);
+
+    return true;
+}
+
+Array MeshOptimizerGD::optimize_surface(const Array &mesh_arrays, int flags, float overdraw_threshold) {
+    mesh_stats::Call call;
+
+    Array result;
+
+    if (mesh_arrays.size() < Mesh::ARRAY_MAX) {
+        UtilityFunctions::push_error("MeshOptimizerGD: Invalid mesh arrays size");
+        return result;
+    }
+
+    Variant v_vertices = mesh_arrays[Mesh::ARRAY_VERTEX];
+    if (v_vertices.get_type() != Variant::PACKED_VECTOR3_ARRAY) {
+        UtilityFunctions::push_error("MeshOptimizerGD: Missing vertices");
+        return result;
+    }
+
+    size_t vertex_count = PackedVector3Array(v_vertices).size();
+    if (vertex_count == 0) {
+        return mesh_arrays;
+    }
+
+    PackedInt32Array indices = surface_indices(mesh_arrays[Mesh::ARRAY_INDEX], vertex_count);
+    if (!valid_triangle_indices(indices, vertex_count)) {
+        UtilityFunctions::push_error("MeshOptimizerGD: Indices out of range or not a triangle list");
+        return result;
+    }
+    size_t index_count = indices.size();
+    call.triangles(index_count / 3, index_count / 3);
+
+    result = mesh_arrays.duplicate();
+
+    if (flags & OPTIMIZE_WELD) {
+        std::vector<Variant> held;
+        std::vector<meshopt_Stream> streams;
+        collect_vertex_streams(result, vertex_count, held, streams);
+
+        PackedInt32Array remap;
+        remap.resize(vertex_count);
+        mesh_stats::Kernel kernel;
+        size_t unique_count = meshopt_generateVertexRemapMulti(
+            index_stream_w(remap),
+            index_stream(indices),
+            index_count,
+            vertex_count,
+            streams.data(),
+            streams.size()
+        );
+
+        if (unique_count < vertex_count) {
+            meshopt_remapIndexBuffer(index_stream_w(indices), index_stream(indices), index_count, index_stream(remap));
+            for (int i = 0; i < Mesh::ARRAY_MAX; i++) {
+                if (i != Mesh::ARRAY_INDEX) {
+                    result[i] = remap_vertex_array(result[i], vertex_count, unique_count, index_stream(remap));
+                }
+            }
+            vertex_count = unique_count;
+        }
+    }
+
+    if (flags & OPTIMIZE_VERTEX_CACHE) {
+        mesh_stats::Kernel kernel;
+        meshopt_optimizeVertexCache(index_stream_w(indices), index_stream(indices), index_count, vertex_count);
+    }
+
+    if (flags & OPTIMIZE_OVERDRAW) {
+        const PackedVector3Array vertices = result[Mesh::ARRAY_VERTEX];
+        std::vector<float> position_scratch;
+        const float *positions = float_stream(vertices.ptr(), vertex_count, position_scratch);
+        mesh_stats::Kernel kernel;
+        meshopt_optimizeOverdraw(
+            index_stream_w(indices),
+            index_stream(indices),
+            index_count,
+            positions,
+            vertex_count,
+            float_stride<Vector3>(),
+            overdraw_threshold
+        );
+    }
+
+    if (flags & OPTIMIZE_VERTEX_FETCH) {
+        return compact_surface(result, indices, vertex_count);
+    }
+
+    result[Mesh::ARRAY_INDEX] = indices;
+    return result;
+}
+
+Array MeshOptimizerGD::generate_shadow_indices(const Array &mesh_arrays, bool position_only) {
+    mesh_stats::Call call;
+
+    Array result;
+
+    if (mesh_arrays.size() < Mesh::ARRAY_MAX) {
+        UtilityFunctions::push_error("MeshOptimizerGD: Invalid mesh arrays size");
+        return result;
+    }
+
+    Variant v_vertices = mesh_arrays[Mesh::ARRAY_VERTEX];
+    if (v_vertices.get_type() != Variant::PACKED_VECTOR3_ARRAY) {
+        UtilityFunctions::push_error("MeshOptimizerGD: Missing vertices");
+        return result;
+    }
+
+    const PackedVector3Array vertices = v_vertices;
+    size_t vertex_count = vertices.size();
+    if (vertex_count == 0) {
+        return mesh_arrays;
+    }
+
+    PackedInt32Array indices = surface_indices(mesh_arrays[Mesh::ARRAY_INDEX], vertex_count);
+    if (!valid_triangle_indices(indices, vertex_count)) {
+        UtilityFunctions::push_error("MeshOptimizerGD: Indices out of range or not a triangle list");
+        return result;
+    }
+    size_t index_count = indices.size();
+
+    std::vector<float> position_scratch;
+    const float *positions = float_stream(vertices.ptr(), vertex_count, position_scratch);
+
+    PackedInt32Array shadow_indices;
+    shadow_indices.resize(index_count);
+    {
+        mesh_stats::Kernel kernel;
+        meshopt_generateShadowIndexBuffer(
+            index_stream_w(shadow_indices),
+            index_stream(indices),
+            index_count,
+            positions,
+            vertex_count,
+            sizeof(float) * 3,
+            float_stride<Vector3>()
+        );
+        meshopt_optimizeVertexCache(index_stream_w(shadow_indices), index_stream(shadow_indices), index_count, vertex_count);
+    }
+    call.triangles(index_count / 3, index_count / 3);
+
+    if (position_only) {
+        Array shadow;
+        shadow.resize(Mesh::ARRAY_MAX);
+        shadow[Mesh::ARRAY_VERTEX] = vertices;
+        return compact_surface(shadow, shadow_indices, vertex_count);
+    }
+
+    result = mesh_arrays.duplicate();
+    result[Mesh::ARRAY_INDEX] = shadow_indices;
+    return result;
+}
+
+Dictionary MeshOptimizerGD::build_meshlets(const Array &mesh_arrays, int max_vertices, int max_triangles, float cone_weight) {
+    mesh_stats::Call call;
+
+    Dictionary result;
+
+    if (mesh_arrays.size() < Mesh::ARRAY_MAX) {
+        result["error"] = "Invalid mesh arrays size";
+        return result;
+    }
+
+    Variant v_vertices = mesh_arrays[Mesh::ARRAY_VERTEX];
+    Variant v_indices = mesh_arrays[Mesh::ARRAY_INDEX];
+
+    if (v_vertices.get_type() != Variant::PACKED_VECTOR3_ARRAY ||
+        v_indices.get_type() != Variant::PACKED_INT32_ARRAY) {
+        result["error"] = "Missing vertices or indices";
+        return result;
+    }
+
+    const PackedVector3Array vertices = v_vertices;
+    const PackedInt32Array indices = v_indices;
+
+    if (vertices.size() == 0 || indices.size() == 0) {
+        result["error"] = "Empty input";
+        return result;
+    }
+
+    size_t vertex_count = vertices.size();
+    if (!valid_triangle_indices(indices, vertex_count)) {
+        result["error"] = "Indices out of range or not a triangle list";
+        return result;
+    }
+
+    // Implementation limits of the clusterizer
+    size_t meshlet_max_vertices = static_cast<size_t>(CLAMP(max_vertices, 3, 255));
+    size_t meshlet_max_triangles = static_cast<size_t>(CLAMP(max_triangles, 4, 512)) & ~size_t(3);
+
+    size_t index_count = indices.size();
+
+    std::vector<float> position_scratch;
+    const float *positions = float_stream(vertices.ptr(), vertex_count, position_scratch);
+
+    size_t max_meshlets = meshopt_buildMeshletsBound(index_count, meshlet_max_vertices, meshlet_max_triangles);
+    std::vector<meshopt_Meshlet> meshlets(max_meshlets);
+    std::vector<unsigned int> meshlet_vertices(max_meshlets * meshlet_max_vertices);
+    std::vector<unsigned char> meshlet_triangles(max_meshlets * meshlet_max_triangles * 3);
+
+    size_t meshlet_count = 0;
+    {
+        mesh_stats::Kernel kernel;
+        meshlet_count = meshopt_buildMeshlets(
+            meshlets.data(),
+            meshlet_vertices.data(),
+            meshlet_triangles.data(),
+            index_stream(indices),
+            index_count,
+            positions,
+            vertex_count,
+            float_stride<Vector3>(),
+            meshlet_max_vertices,
+            meshlet_max_triangles,
+            cone_weight
+        );
+    }
+
+    PackedInt32Array new_indices;
+    PackedInt32Array index_offsets;
+    PackedInt32Array index_counts;
+    PackedFloat32Array spheres;
+    PackedVector3Array aabb_positions;
+    PackedVector3Array aabb_sizes;
+    PackedVector3Array cone_apexes;
+    PackedVector3Array cone_axes;
+    PackedFloat32Array cone_cutoffs;
+
+    new_indices.resize(index_count);
+    index_offsets.resize(meshlet_count);
+    index_counts.resize(meshlet_count);
+    spheres.resize(meshlet_count * 4);
+    aabb_positions.resize(meshlet_count);
+    aabb_sizes.resize(meshlet_count);
+    cone_apexes.resize(meshlet_count);
+    cone_axes.resize(meshlet_count);
+    cone_cutoffs.resize(meshlet_count);
+
+    int32_t *w_indices = new_indices.ptrw();
+    size_t written = 0;
+
+    for (size_t m = 0; m < meshlet_count; m++) {
+        const meshopt_Meshlet &meshlet = meshlets[m];
+        unsigned int *local_vertices = &meshlet_vertices[meshlet.vertex_offset];
+        unsigned char *local_triangles = &meshlet_triangles[meshlet.triangle_offset];
+
+        meshopt_Bounds bounds;
+        {
+            mesh_stats::Kernel kernel;
+            meshopt_optimizeMeshlet(local_vertices, local_triangles, meshlet.triangle_count, meshlet.vertex_count);
+
+            bounds = meshopt_computeMeshletBounds(
+                local_vertices,
+                local_triangles,
+                meshlet.triangle_count,
+                positions,
+                vertex_count,
+                float_stride<Vector3>()
+            );
+        }
+
+        // Expand micro indices back to surface indices
+        index_offsets.set(m, static_cast<int32_t>(written));
+        index_counts.set(m, static_cast<int32_t>(meshlet.triangle_count * 3));
+        for (size_t i = 0; i < meshlet.triangle_count * 3; i++) {
+            w_indices[written++] = static_cast<int32_t>(local_vertices[local_triangles[i]]);
+        }
+
+        AABB aabb(vertices[local_vertices[0]], Vector3());
+        for (size_t i = 1; i < meshlet.vertex_count; i++) {
+            aabb.expand_to(vertices[local_vertices[i]]);
+        }
+
+        spheres.set(m * 4 + 0, bounds.center[0]);
+        spheres.set(m * 4 + 1, bounds.center[1]);
+        spheres.set(m * 4 + 2, bounds.center[2]);
+        spheres.set(m * 4 + 3, bounds.radius);
+        aabb_positions.set(m, aabb.position);
+        aabb_sizes.set(m, aabb.size);
+        cone_apexes.set(m, Vector3(bounds.cone_apex[0], bounds.cone_apex[1], bounds.cone_apex[2]));
+        cone_axes.set(m, Vector3(bounds.cone_axis[0], bounds.cone_axis[1], bounds.cone_axis[2]));
+        cone_cutoffs.set(m, bounds.cone_cutoff);
+    }
+
+    // Degenerate triangles are dropped by the clusterizer
+    new_indices.resize(written);
+    call.triangles(index_count / 3, written / 3);
+
+    result["indices"] = new_indices;
+    result["index_offsets"] = index_offsets;
+    result["index_counts"] = index_counts;
+    result["spheres"] = spheres;
+    result["aabb_positions"] = aabb_positions;
+    result["aabb_sizes"] = aabb_sizes;
+    result["cone_apexes"] = cone_apexes;
+    result["cone_axes"] = cone_axes;
+    result["cone_cutoffs"] = cone_cutoffs;
+    result["meshlet_count"] = static_cast<int>(meshlet_count);
+
+    return result;
+}
+
+PackedByteArray MeshOptimizerGD::encode_surface(const Array &mesh_arrays, const Dictionary &options) {
+    Array surfaces;
+    surfaces.push_back(mesh_arrays);
+    return encode_surfaces(surfaces, options);
+}
+
+PackedByteArray MeshOptimizerGD::encode_surfaces(const Array &surfaces, const Dictionary &options) {
+    mesh_stats::Call call;
+    String error;
+    PackedByteArray result;
+    {
+        // As in decoding, the codec's conversions and the meshopt encoders all count as kernel time
+        mesh_stats::Kernel kernel;
+        result = mesh_codec::encode_surfaces(surfaces, encode_options(options), error);
+    }
+    if (!result.is_empty()) {
+        size_t triangles = 0;
+        for (int64_t i = 0; i < surfaces.size(); i++) {
+            const Array mesh_arrays = surfaces[i];
+            Variant v_indices = mesh_arrays[Mesh::ARRAY_INDEX];
+            triangles += (v_indices.get_type() == Variant::PACKED_INT32_ARRAY && PackedInt32Array(v_indices).size() > 0
+                    ? PackedInt32Array(v_indices).size()
+                    : PackedVector3Array(mesh_arrays[Mesh::ARRAY_VERTEX]).size()) / 3;
+        }
+        call.triangles(triangles, triangles);
+    }
+    if (!error.is_empty()) {
+        UtilityFunctions::push_error("MeshOptimizerGD: ", error);
+    }
+    return result;
+}
+
+Array MeshOptimizerGD::decode_surface(const PackedByteArray &data, int surface_index) {
+    return _decode_surface(data.ptr(), data.size(), surface_index);
+}
+
+Array MeshOptimizerGD::decode_surfaces(const PackedByteArray &data) {
+    return _decode_surfaces(data.ptr(), data.size());
+}
+
+Array MeshOptimizerGD::_decode_surface(const uint8_t *data, size_t size, int surface_index) {
+    mesh_stats::Call call;
+    String error;
+    Array result;
+    {
+        // The codec writes straight into the packed arrays, so decoding counts as kernel time
+        mesh_stats::Kernel kernel;
+        result = mesh_codec::decode_surface(data, size, surface_index, error);
+    }
+    if (!error.is_empty()) {
+        UtilityFunctions::push_error("MeshOptimizerGD: ", error);
+    }
+    return result;
+}
+
+Array MeshOptimizerGD::_decode_surfaces(const uint8_t *data, size_t size) {
+    mesh_stats::Call call;
+
+    Array result;
+
+    int surface_count = mesh_codec::get_surface_count(data, size);
+    if (surface_count < 0) {
+        UtilityFunctions::push_error("MeshOptimizerGD: Not a meshoptimizer surface container");
+        return result;
+    }
+
+    for (int i = 0; i < surface_count; i++) {
+        Array surface = _decode_surface(data, size, i);
+        if (surface.is_empty()) {
+            return Array();
+        }
+        result.push_back(surface);
+    }
+
+    return result;
+}
+
+int MeshOptimizerGD::get_encoded_surface_count(const PackedByteArray &data) {
+    return mesh_codec::get_surface_count(data.ptr(), data.size());
+}
+
+PackedByteArray MeshOptimizerGD::encode_progressive(const Array &mesh_arrays, const PackedFloat32Array &ratios, const Dictionary &options) {
+    mesh_stats::Call call;
+
+    PackedByteArray result;
+
+    if (mesh_arrays.size() < Mesh::ARRAY_MAX || mesh_arrays[Mesh::ARRAY_INDEX].get_type() != Variant::PACKED_INT32_ARRAY) {
+        UtilityFunctions::push_error("MeshOptimizerGD: encode_progressive needs indexed mesh arrays");
+        return result;
+    }
+    const PackedInt32Array indices = mesh_arrays[Mesh::ARRAY_INDEX];
+
+    // The chain simplifies each level from the previous one, so it runs finest first
+    std::vector<float> coarse_ratios;
+    for (int64_t i = 0; i < ratios.size(); i++) {
+        if (ratios[i] > 0.0f && ratios[i] < 1.0f) {
+            coarse_ratios.push_back(ratios[i]);
+        }
+    }
+    if (ratios.is_empty()) {
+        coarse_ratios = { 0.0625f, 0.125f, 0.25f, 0.5f };
+    }
+    std::sort(coarse_ratios.begin(), coarse_ratios.end(), [](float a, float b) { return a > b; });
+
+    PackedFloat32Array chain_ratios;
+    for (float ratio : coarse_ratios) {
+        chain_ratios.push_back(ratio);
+    }
+
+    Array chain;
+    if (!chain_ratios.is_empty()) {
+        chain = _generate_lod_chain(mesh_arrays, chain_ratios, options.get("target_error", 0.01f), options.get("attribute_weights", Dictionary()), options);
+    }
+
+    // Full mesh last, then prepend each coarser level that still removes triangles
+    std::vector<mesh_codec::ProgressiveLevel> levels(1);
+    levels[0].indices = indices;
+    for (int64_t i = 0; i < chain.size(); i++) {
+        Dictionary lod = chain[i];
+        PackedInt32Array lod_indices = lod["indices"];
+        if (lod_indices.is_empty() || lod_indices.size() >= levels.front().indices.size()) {
+            continue;
+        }
+        mesh_codec::ProgressiveLevel level;
+        level.indices = lod_indices;
+        level.world_error = lod["world_error"];
+        levels.insert(levels.begin(), level);
+    }
+
+    String error;
+    {
+        mesh_stats::Kernel kernel;
+        result = mesh_codec::encode_progressive(mesh_arrays, levels, encode_options(options), error);
+    }
+    if (!error.is_empty()) {
+        UtilityFunctions::push_error("MeshOptimizerGD: ", error);
+    }
+    call.triangles(indices.size() / 3, indices.size() / 3);
+
+    return result;
+}
+
+Dictionary MeshOptimizerGD::get_progressive_info(const PackedByteArray &data) {
+    return _get_progressive_info(data.ptr(), data.size());
+}
+
+Array MeshOptimizerGD::decode_progressive(const PackedByteArray &data, int level) {
+    return _decode_progressive(data.ptr(), data.size(), level);
+}
+
+Dictionary MeshOptimizerGD::_get_progressive_info(const uint8_t *data, size_t size) {
+    Dictionary result;
+
+    mesh_codec::ProgressiveInfo info;
+    String error;
+    if (!mesh_codec::get_progressive_info(data, size, info, error)) {
+        result["error"] = error;
+        if (info.header_size > 0) {
+            result["header_bytes"] = static_cast<int64_t>(info.header_size);
+        }
+        return result;
+    }
+
+    Array levels;
+    for (const mesh_codec::ProgressiveLevelInfo &level : info.levels) {
+        Dictionary entry;
+        entry["bytes"] = static_cast<int64_t>(level.end);
+        entry["vertices"] = static_cast<int64_t>(level.vertex_count);
+        entry["triangles"] = static_cast<int64_t>(level.index_count / 3);
+        entry["world_error"] = level.world_error;
+        levels.push_back(entry);
+    }
+
+    result["levels"] = levels;
+    result["loaded_levels"] = info.loaded_levels;
+    result["vertex_count"] = static_cast<int64_t>(info.vertex_count);
+    result["header_bytes"] = static_cast<int64_t>(info.header_size);
+    return result;
+}
+
+Array MeshOptimizerGD::_decode_progressive(const uint8_t *data, size_t size, int level) {
+    mesh_stats::Call call;
+    String error;
+    Array result;
+    {
+        mesh_stats::Kernel kernel;
+        result = mesh_codec::decode_progressive(data, size, level, error);
+    }
+    if (!error.is_empty()) {
+        UtilityFunctions::push_error("MeshOptimizerGD: ", error);
+    }
+    return result;
+}
+
+Dictionary MeshOptimizerGD::build_surface_data(const Array &mesh_arrays, const Array &lods, int primitive) {
+    mesh_stats::Call call;
+    String error;
+    Dictionary result = mesh_surface::build_surface_data(mesh_arrays, lods, primitive, error);
+    if (!error.is_empty()) {
+        result["error"] = error;
+    }
+    return result;
+}
+
+Dictionary MeshOptimizerGD::quantize_surface(const Array &mesh_arrays, const Dictionary &options) {
+    mesh_stats::Call call;
+
+    Dictionary result;
+
+    if (mesh_arrays.size() < Mesh::ARRAY_MAX) {
+        result["error"] = "Invalid mesh arrays size";
+        return result;
+    }
+
+    Variant v_vertices = mesh_arrays[Mesh::ARRAY_VERTEX];
+    if (v_vertices.get_type() != Variant::PACKED_VECTOR3_ARRAY || PackedVector3Array(v_vertices).size() == 0) {
+        result["error"] = "Missing vertices";
+        return result;
+    }
+
+    String format_name = options.get("format", "compressed");
+    QuantizeFormat format;
+    if (format_name == "compressed") {
+        format = QUANTIZE_COMPRESSED;
+    } else if (format_name == "half") {
+        format = QUANTIZE_HALF;
+    } else if (format_name == "float") {
+        format = QUANTIZE_FLOAT;
+    } else {
+        result["error"] = String("Unknown format: ") + format_name;
+        return result;
+    }
+    int float_bits = CLAMP(static_cast<int>(options.get("float_bits", 10)), 1, 23);
+    float max_position_error = options.get("max_position_error", 0.0f);
+    float max_normal_error = options.get("max_normal_error", 0.0f);
+    float max_uv_error = options.get("max_uv_error", 0.0f);
+
+    Array arrays = mesh_arrays.duplicate();
+    Dictionary half_streams;
+    Dictionary report;
+
+    // Positions
+    const PackedVector3Array vertices = v_vertices;
+    size_t vertex_count = vertices.size();
+    ErrorStats position_stats;
+    {
+        AABB aabb(vertices[0], Vector3());
+        for (size_t i = 1; i < vertex_count; i++) {
+            aabb.expand_to(vertices[i]);
+        }
+
+        PackedVector3Array quantized;
+        quantized.resize(vertex_count);
+        Vector3 *w = quantized.ptrw();
+        for (size_t i = 0; i < vertex_count; i++) {
+            const Vector3 &v = vertices[i];
+            if (format == QUANTIZE_COMPRESSED) {
+                w[i] = Vector3(
+                    quantize_range16(v.x, aabb.position.x, aabb.size.x),
+                    quantize_range16(v.y, aabb.position.y, aabb.size.y),
+                    quantize_range16(v.z, aabb.position.z, aabb.size.z)
+                );
+            } else {
+                w[i] = Vector3(
+                    quantize_scalar(v.x, format, float_bits),
+                    quantize_scalar(v.y, format, float_bits),
+                    quantize_scalar(v.z, format, float_bits)
+                );
+            }
+            position_stats.add((w[i] - v).length());
+        }
+        arrays[Mesh::ARRAY_VERTEX] = quantized;
+
+        if (format == QUANTIZE_HALF) {
+            std::vector<float> scratch;
+            half_streams[Mesh::ARRAY_VERTEX] = half_stream(float_stream(vertices.ptr(), vertex_count, scratch), vertex_count, 3, 4);
+        }
+    }
+    report["position_max_error"] = position_stats.max_error;
+    report["position_avg_error"] = position_stats.average();
+
+    // Normals and tangent directions
+    ErrorStats normal_stats;
+    for (int array_type : { Mesh::ARRAY_NORMAL, Mesh::ARRAY_TANGENT }) {
+        Variant value = mesh_arrays[array_type];
+        bool is_normal = array_type == Mesh::ARRAY_NORMAL;
+
+        std::vector<float> vectors; // xyzw
+        if (is_normal && value.get_type() == Variant::PACKED_VECTOR3_ARRAY && PackedVector3Array(value).size() == static_cast<int64_t>(vertex_count)) {
+            const PackedVector3Array normals = value;
+            vectors.resize(vertex_count * 4);
+            for (size_t i = 0; i < vertex_count; i++) {
+                vectors[i * 4 + 0] = normals[i].x;
+                vectors[i * 4 + 1] = normals[i].y;
+                vectors[i * 4 + 2] = normals[i].z;
+                vectors[i * 4 + 3] = 0.0f;
+            }
+        } else if (!is_normal && value.get_type() == Variant::PACKED_FLOAT32_ARRAY && PackedFloat32Array(value).size() == static_cast<int64_t>(vertex_count * 4)) {
+            const PackedFloat32Array tangents = value;
+            vectors.assign(tangents.ptr(), tangents.ptr() + vertex_count * 4);
+        } else {
+            continue;
+        }
+
+        std::vector<float> original = vectors;
+        if (format == QUANTIZE_COMPRESSED) {
+            quantize_octahedral(vectors, vertex_count);
+        } else {
+            for (size_t i = 0; i < vertex_count; i++) {
+                for (int c = 0; c < 3; c++) {
+                    vectors[i * 4 + c] = quantize_scalar(vectors[i * 4 + c], format, float_bits);
+                }
+            }
+        }
+
+        for (size_t i = 0; i < vertex_count; i++) {
+            normal_stats.add(angle_degrees(
+                Vector3(original[i * 4 + 0], original[i * 4 + 1], original[i * 4 + 2]),
+                Vector3(vectors[i * 4 + 0], vectors[i * 4 + 1], vectors[i * 4 + 2])
+            ));
+        }
+
+        if (is_normal) {
+            PackedVector3Array quantized;
+            quantized.resize(vertex_count);
+            Vector3 *w = quantized.ptrw();
+            for (size_t i = 0; i < vertex_count; i++) {
+                w[i] = Vector3(vectors[i * 4 + 0], vectors[i * 4 + 1], vectors[i * 4 + 2]);
+            }
+            arrays[array_type] = quantized;
+        } else {
+            PackedFloat32Array quantized;
+            quantized.resize(vertex_count * 4);
+            memcpy(quantized.ptrw(), vectors.data(), vectors.size() * sizeof(float));
+            arrays[array_type] = quantized;
+        }
+
+        if (format == QUANTIZE_HALF) {
+            half_streams[array_type] = half_stream(original.data(), vertex_count, 4, 0);
+        }
+    }
+    report["normal_max_error"] = normal_stats.max_error;
+    report["normal_avg_error"] = normal_stats.average();
+
+    // UVs
+    ErrorStats uv_stats;
+    for (int array_type : { Mesh::ARRAY_TEX_UV, Mesh::ARRAY_TEX_UV2 }) {
+        Variant value = mesh_arrays[array_type];
+        if (value.get_type() != Variant::PACKED_VECTOR2_ARRAY || PackedVector2Array(value).size() != static_cast<int64_t>(vertex_count)) {
+            continue;
+        }
+
+        const PackedVector2Array uvs = value;
+        Vector2 uv_min = uvs[0];
+        Vector2 uv_max = uvs[0];
+        for (size_t i = 1; i < vertex_count; i++) {
+            uv_min = Vector2(MIN(uv_min.x, uvs[i].x), MIN(uv_min.y, uvs[i].y));
+            uv_max = Vector2(MAX(uv_max.x, uvs[i].x), MAX(uv_max.y, uvs[i].y));
+        }
+
+        PackedVector2Array quantized;
+        quantized.resize(vertex_count);
+        Vector2 *w = quantized.ptrw();
+        for (size_t i = 0; i < vertex_count; i++) {
+            const Vector2 &uv = uvs[i];
+            if (format == QUANTIZE_COMPRESSED) {
+                w[i] = Vector2(
+                    quantize_range16(uv.x, uv_min.x, uv_max.x - uv_min.x),
+                    quantize_range16(uv.y, uv_min.y, uv_max.y - uv_min.y)
+                );
+            } else {
+                w[i] = Vector2(quantize_scalar(uv.x, format, float_bits), quantize_scalar(uv.y, format, float_bits));
+            }
+            uv_stats.add(MAX(std::abs(w[i].x - uv.x), std::abs(w[i].y - uv.y)));
+        }
+        arrays[array_type] = quantized;
+
+        if (format == QUANTIZE_HALF) {
+            std::vector<float> scratch;
+            half_streams[array_type] = half_stream(float_stream(uvs.ptr(), vertex_count, scratch), vertex_count, 2, 0);
+        }
+    }
+    report["uv_max_error"] = uv_stats.max_error;
+    report["uv_avg_error"] = uv_stats.average();
+
+    bool accepted = (max_position_error <= 0.0f || position_stats.max_error <= max_position_error) &&
+        (max_normal_error <= 0.0f || normal_stats.max_error <= max_normal_error) &&
+        (max_uv_error <= 0.0f || uv_stats.max_error <= max_uv_error);
+
+    int64_t flags = 0;
+    if (format == QUANTIZE_COMPRESSED && accepted) {
+        flags = Mesh::ARRAY_FLAG_COMPRESS_ATTRIBUTES;
+    }
+
+    result["arrays"] = arrays;
+    result["accepted"] = accepted;
+    result["flags"] = flags;
+    result["report"] = report;
+    if (format == QUANTIZE_HALF) {
+        result["half_streams"] = half_streams;
+    }
+
+    return result;
+}
+
+Dictionary MeshOptimizerGD::analyze_surface(const Array &mesh_arrays, int cache_size) {
+    mesh_stats::Call call;
+
     Dictionary result;
 
-    if (vertices.size() == 0 || indices.size() == 0) {
-        result["error"] = "Empty input";
+    if (mesh_arrays.size() < Mesh::ARRAY_MAX) {
+        result["error"] = "Invalid mesh arrays size";
         return result;
     }
 
-    size_t vertex_count = vertices.size();
-    size_t index_count = indices.size();
-    size_t target_index_count = static_cast<size_t>(index_count * target_ratio);
+    Variant v_vertices = mesh_arrays[Mesh::ARRAY_VERTEX];
+    if (v_vertices.get_type() != Variant::PACKED_VECTOR3_ARRAY || PackedVector3Array(v_vertices).size() == 0) {
+        result["error"] = "Missing vertices";
+        return result;
+    }
 
-    // Ensure minimum
-    if (target_index_count < 3) target_index_count = 3;
+    const PackedVector3Array vertices = v_vertices;
+    size_t vertex_count = vertices.size();
 
-    // Convert to raw arrays
-    std::vector<float> vertex_data(vertex_count * 3);
-    for (size_t i = 0; i < vertex_count; i++) {
-        Vector3 v = vertices[i];
-        vertex_data[i * 3 + 0] = v.x;
-        vertex_data[i * 3 + 1] = v.y;
-        vertex_data[i * 3 + 2] = v.z;
+    PackedInt32Array indices = surface_indices(mesh_arrays[Mesh::ARRAY_INDEX], vertex_count);
+    if (!valid_triangle_indices(indices, vertex_count)) {
+        result["error"] = "Indices out of range or not a triangle list";
+        return result;
     }
+    size_t index_count = indices.size();
 
-    std::vector<unsigned int> index_data(index_count);
-    for (size_t i = 0; i < index_count; i++) {
-        index_data[i] = static_cast<unsigned int>(indices[i]);
+    std::vector<Variant> held;
+    std::vector<meshopt_Stream> streams;
+    collect_vertex_streams(mesh_arrays, vertex_count, held, streams);
+    size_t vertex_size = 0;
+    for (const meshopt_Stream &stream : streams) {
+        vertex_size += stream.size;
     }
 
-    // Output buffer
-    std::vector<unsigned int> simplified_indices(index_count);
-    float result_error = 0.0f;
-
-    // Run simplification
-    size_t new_index_count = meshopt_simplify(
-        simplified_indices.data(),
-        index_data.data(),
-        index_count,
-        vertex_data.data(),
-        vertex_count,
-        sizeof(float) * 3,
-        target_index_count,
-        target_error,
-        0, // options
-        &result_error
-    );
-
-    // Convert back to Godot types
-    PackedInt32Array new_indices;
-    new_indices.resize(new_index_count);
-    for (size_t i = 0; i < new_index_count; i++) {
-        new_indices[i] = static_cast<int32_t>(simplified_indices[i]);
+    std::vector<float> position_scratch;
+    const float *positions = float_stream(vertices.ptr(), vertex_count, position_scratch);
+
+    meshopt_VertexCacheStatistics cache;
+    meshopt_OverdrawStatistics overdraw;
+    meshopt_VertexFetchStatistics fetch;
+    {
+        mesh_stats::Kernel kernel;
+        cache = meshopt_analyzeVertexCache(
+            index_stream(indices), index_count, vertex_count, MAX(cache_size, 1), 0, 0);
+        overdraw = meshopt_analyzeOverdraw(
+            index_stream(indices), index_count, positions, vertex_count, float_stride<Vector3>());
+        fetch = meshopt_analyzeVertexFetch(
+            index_stream(indices), index_count, vertex_count, vertex_size);
     }
-
-    result["indices"] = new_indices;
-    result["vertices"] = vertices; // Vertices unchanged, just reindexed
-    result["result_error"] = result_error;
-    result["original_triangles"] = static_cast<int>(index_count / 3);
-    result["simplified_triangles"] = static_cast<int>(new_index_count / 3);
+    call.triangles(index_count / 3, index_count / 3);
+
+    result["vertex_count"] = static_cast<int64_t>(vertex_count);
+    result["triangle_count"] = static_cast<int64_t>(index_count / 3);
+    result["vertex_size"] = static_cast<int64_t>(vertex_size);
+    result["acmr"] = cache.acmr;
+    result["atvr"] = cache.atvr;
+    result["vertices_transformed"] = cache.vertices_transformed;
+    result["overdraw"] = overdraw.overdraw;
+    result["pixels_covered"] = overdraw.pixels_covered;
+    result["pixels_shaded"] = overdraw.pixels_shaded;
+    result["overfetch"] = fetch.overfetch;
+    result["bytes_fetched"] = fetch.bytes_fetched;
 
     return result;
 }
 
-Dictionary MeshOptimizerGD::simplify_with_attributes(
-    PackedVector3Array vertices,
-    PackedInt32Array indices,
-    PackedVector2Array uvs,
-    float target_ratio,
-    float target_error,
-    float uv_weight
-) {
+Dictionary MeshOptimizerGD::analyze_directory(const String &path, const String &report_path, const Dictionary &thresholds) {
+    mesh_stats::Call call;
+
     Dictionary result;
 
-    if (vertices.size() == 0 || indices.size() == 0) {
-        result["error"] = "Empty input";
-        return result;
+    PackedStringArray files;
+    collect_resource_files(path, files);
+
+    std::vector<Dictionary> entries;
+    int failed_count = 0;
+    size_t triangles = 0;
+    for (int f = 0; f < files.size(); f++) {
+        Ref<Mesh> mesh = ResourceLoader::get_singleton()->load(files[f]);
+        if (mesh.is_null()) {
+            continue;
+        }
+
+        for (int s = 0; s < mesh->get_surface_count(); s++) {
+            if (mesh->surface_get_primitive_type(s) != Mesh::PRIMITIVE_TRIANGLES) {
+                continue;
+            }
+
+            Dictionary entry = analyze_surface(mesh->surface_get_arrays(s));
+            if (entry.has("error")) {
+                continue;
+            }
+            entry["path"] = files[f];
+            entry["surface"] = s;
+            triangles += static_cast<size_t>(int64_t(entry["triangle_count"]));
+
+            PackedStringArray failed;
+            for (const char *metric : ANALYSIS_METRICS) {
+                String key = String("max_") + metric;
+                if (thresholds.has(key) && float(entry[metric]) > float(thresholds[key])) {
+                    failed.push_back(metric);
+                }
+            }
+            entry["failed"] = failed;
+            if (failed.size() > 0) {
+                failed_count++;
+            }
+
+            entries.push_back(entry);
+        }
     }
 
-    size_t vertex_count = vertices.size();
-    size_t index_count = indices.size();
-    size_t target_index_count = static_cast<size_t>(index_count * target_ratio);
+    // The nested analyze_surface calls each set their own count, so the total goes in last
+    call.triangles(triangles, triangles);
 
-    if (target_index_count < 3) target_index_count = 3;
+    std::stable_sort(entries.begin(), entries.end(), [](const Dictionary &a, const Dictionary &b) {
+        return int64_t(a["vertices_transformed"]) > int64_t(b["vertices_transformed"]);
+    });
 
-    // Convert vertices
-    std::vector<float> vertex_data(vertex_count * 3);
-    for (size_t i = 0; i < vertex_count; i++) {
-        Vector3 v = vertices[i];
-        vertex_data[i * 3 + 0] = v.x;
-        vertex_data[i * 3 + 1] = v.y;
-        vertex_data[i * 3 + 2] = v.z;
+    Array entry_array;
+    for (const Dictionary &entry : entries) {
+        entry_array.push_back(entry);
     }
 
-    std::vector<unsigned int> index_data(index_count);
-    for (size_t i = 0; i < index_count; i++) {
-        index_data[i] = static_cast<unsigned int>(indices[i]);
+    result["entries"] = entry_array;
+    result["file_count"] = files.size();
+    result["failed_count"] = failed_count;
+    result["passed"] = failed_count == 0;
+
+    if (!report_path.is_empty()) {
+        Ref<FileAccess> file = FileAccess::open(report_path, FileAccess::WRITE);
+        if (file.is_null()) {
+            result["error"] = String("Cannot write report: ") + report_path;
+            return result;
+        }
+        if (report_path.get_extension().to_lower() == "csv") {
+            file->store_string(analysis_csv(entry_array));
+        } else {
+            file->store_string(JSON::stringify(result, "\t"));
+        }
     }
 
-    // Output buffer
-    std::vector<unsigned int> simplified_indices(index_count);
-    float result_error = 0.0f;
+    return result;
+}
 
-    // If UVs provided and match vertex count, use attribute-aware simplification
-    if (uvs.size() == vertex_count) {
-        // Prepare UV attributes
-        std::vector<float> uv_data(vertex_count * 2);
-        for (size_t i = 0; i < vertex_count; i++) {
-            Vector2 uv = uvs[i];
-            uv_data[i * 2 + 0] = uv.x;
-            uv_data[i * 2 + 1] = uv.y;
+Array MeshOptimizerGD::_merge_surfaces(const Array &surfaces, const Array &transforms, const Dictionary &params) {
+    mesh_stats::Call call;
+
+    Array result;
+
+    Array materials = params.get("materials", Array());
+    float target_ratio = params.get("target_ratio", 1.0f);
+    float target_error = params.get("target_error", 0.01f);
+    Dictionary attribute_weights = params.get("attribute_weights", Dictionary());
+    bool weld = params.get("weld", true);
+    bool view_orders = params.get("view_orders", false);
+    PackedVector3Array directions = view_orders ? view_directions(params) : PackedVector3Array();
+
+    // Validate and group by material
+    std::vector<size_t> vertex_counts(surfaces.size(), 0);
+    std::vector<MergeGroup> groups;
+    size_t input_triangles = 0;
+    size_t output_triangles = 0;
+    for (int i = 0; i < surfaces.size(); i++) {
+        Array mesh_arrays = surfaces[i];
+        if (mesh_arrays.size() < Mesh::ARRAY_MAX) {
+            UtilityFunctions::push_error("MeshOptimizerGD: Invalid mesh arrays size in surface ", i);
+            return Array();
         }
 
-        float attribute_weights[1] = { uv_weight };
+        Variant v_vertices = mesh_arrays[Mesh::ARRAY_VERTEX];
+        if (v_vertices.get_type() != Variant::PACKED_VECTOR3_ARRAY) {
+            UtilityFunctions::push_error("MeshOptimizerGD: Missing vertices in surface ", i);
+            return Array();
+        }
+        vertex_counts[i] = PackedVector3Array(v_vertices).size();
+        if (vertex_counts[i] == 0) {
+            continue;
+        }
 
-        size_t new_index_count = meshopt_simplifyWithAttributes(
-            simplified_indices.data(),
-            index_data.data(),
-            index_count,
-            vertex_data.data(),
-            vertex_count,
-            sizeof(float) * 3,
-            uv_data.data(),
-            sizeof(float) * 2,
-            attribute_weights,
-            1, // attribute count
-            nullptr, // vertex lock (optional)
-            target_index_count,
-            target_error,
-            0,
-            &result_error
-        );
+        // Rebased indices that leave their surface would point into a neighbour or past the buffer
+        Variant v_indices = mesh_arrays[Mesh::ARRAY_INDEX];
+        bool indexed = v_indices.get_type() == Variant::PACKED_INT32_ARRAY && PackedInt32Array(v_indices).size() > 0;
+        if (indexed ? !valid_triangle_indices(v_indices, vertex_counts[i]) : vertex_counts[i] % 3 != 0) {
+            UtilityFunctions::push_error("MeshOptimizerGD: Indices out of range or not a triangle list in surface ", i);
+            return Array();
+        }
 
-        // Convert back
-        PackedInt32Array new_indices;
-        new_indices.resize(new_index_count);
-        for (size_t i = 0; i < new_index_count; i++) {
-            new_indices[i] = static_cast<int32_t>(simplified_indices[i]);
+        Variant material = i < materials.size() ? materials[i] : Variant();
+        MergeGroup *group = nullptr;
+        for (MergeGroup &existing : groups) {
+            if (existing.material == material) {
+                group = &existing;
+                break;
+            }
+        }
+        if (!group) {
+            groups.push_back({ material, {} });
+            group = &groups.back();
         }
+        group->members.push_back(i);
+    }
 
-        result["indices"] = new_indices;
-        result["vertices"] = vertices;
-        result["uvs"] = uvs;
-        result["result_error"] = result_error;
-        result["original_triangles"] = static_cast<int>(index_count / 3);
-        result["simplified_triangles"] = static_cast<int>(new_index_count / 3);
-    } else {
-        // Fall back to regular simplification
-        return simplify(vertices, indices, target_ratio, target_error);
+    for (const MergeGroup &group : groups) {
+        // Size the merged buffers and pick the attributes every member provides
+        size_t total_vertices = 0;
+        size_t total_indices = 0;
+        bool keep[Mesh::ARRAY_MAX] = {};
+        for (int array_type : MERGE_ARRAYS) {
+            keep[array_type] = true;
+        }
+        for (int i : group.members) {
+            Array mesh_arrays = surfaces[i];
+            Variant v_indices = mesh_arrays[Mesh::ARRAY_INDEX];
+            bool indexed = v_indices.get_type() == Variant::PACKED_INT32_ARRAY && PackedInt32Array(v_indices).size() > 0;
+            total_vertices += vertex_counts[i];
+            total_indices += indexed ? PackedInt32Array(v_indices).size() : vertex_counts[i];
+            for (int array_type : MERGE_ARRAYS) {
+                keep[array_type] = keep[array_type] && has_merge_array(mesh_arrays, array_type, vertex_counts[i]);
+            }
+        }
+
+        PackedVector3Array vertices;
+        PackedVector3Array normals;
+        PackedFloat32Array tangents;
+        PackedColorArray colors;
+        PackedVector2Array uvs;
+        PackedVector2Array uv2s;
+        PackedInt32Array indices;
+        vertices.resize(total_vertices);
+        indices.resize(total_indices);
+        if (keep[Mesh::ARRAY_NORMAL]) normals.resize(total_vertices);
+        if (keep[Mesh::ARRAY_TANGENT]) tangents.resize(total_vertices * 4);
+        if (keep[Mesh::ARRAY_COLOR]) colors.resize(total_vertices);
+        if (keep[Mesh::ARRAY_TEX_UV]) uvs.resize(total_vertices);
+        if (keep[Mesh::ARRAY_TEX_UV2]) uv2s.resize(total_vertices);
+
+        size_t vertex_offset = 0;
+        size_t index_offset = 0;
+        for (int i : group.members) {
+            Array mesh_arrays = surfaces[i];
+            size_t vertex_count = vertex_counts[i];
+
+            Transform3D xform;
+            if (i < transforms.size() && transforms[i].get_type() == Variant::TRANSFORM3D) {
+                xform = transforms[i];
+            }
+            const Basis &basis = xform.basis;
+            Basis normal_basis = basis.inverse().transposed();
+            bool mirrored = basis.determinant() < 0;
+
+            const PackedVector3Array src_vertices = mesh_arrays[Mesh::ARRAY_VERTEX];
+            const Vector3 *sv = src_vertices.ptr();
+            Vector3 *dv = vertices.ptrw() + vertex_offset;
+            for (size_t v = 0; v < vertex_count; v++) {
+                dv[v] = xform.xform(sv[v]);
+            }
+
+            if (keep[Mesh::ARRAY_NORMAL]) {
+                const PackedVector3Array src_normals = mesh_arrays[Mesh::ARRAY_NORMAL];
+                const Vector3 *sn = src_normals.ptr();
+                Vector3 *dn = normals.ptrw() + vertex_offset;
+                for (size_t v = 0; v < vertex_count; v++) {
+                    dn[v] = normal_basis.xform(sn[v]).normalized();
+                }
+            }
+
+            if (keep[Mesh::ARRAY_TANGENT]) {
+                // Mirroring flips the bitangent, which Godot stores as the sign in w
+                const PackedFloat32Array src_tangents = mesh_arrays[Mesh::ARRAY_TANGENT];
+                const float *st = src_tangents.ptr();
+                float *dt = tangents.ptrw() + vertex_offset * 4;
+                for (size_t v = 0; v < vertex_count; v++) {
+                    Vector3 t = basis.xform(Vector3(st[v * 4 + 0], st[v * 4 + 1], st[v * 4 + 2])).normalized();
+                    dt[v * 4 + 0] = t.x;
+                    dt[v * 4 + 1] = t.y;
+                    dt[v * 4 + 2] = t.z;
+                    dt[v * 4 + 3] = mirrored ? -st[v * 4 + 3] : st[v * 4 + 3];
+                }
+            }
+
+            if (keep[Mesh::ARRAY_COLOR]) copy_packed(colors, vertex_offset, mesh_arrays[Mesh::ARRAY_COLOR]);
+            if (keep[Mesh::ARRAY_TEX_UV]) copy_packed(uvs, vertex_offset, mesh_arrays[Mesh::ARRAY_TEX_UV]);
+            if (keep[Mesh::ARRAY_TEX_UV2]) copy_packed(uv2s, vertex_offset, mesh_arrays[Mesh::ARRAY_TEX_UV2]);
+
+            // Rebase indices, swapping two corners of each triangle on mirrored instances to keep the winding
+            int32_t *di = indices.ptrw() + index_offset;
+            Variant v_indices = mesh_arrays[Mesh::ARRAY_INDEX];
+            size_t index_count;
+            if (v_indices.get_type() == Variant::PACKED_INT32_ARRAY && PackedInt32Array(v_indices).size() > 0) {
+                const PackedInt32Array src_indices = v_indices;
+                index_count = src_indices.size();
+                offset_indices(reinterpret_cast<uint32_t *>(di), index_stream(src_indices), index_count, static_cast<uint32_t>(vertex_offset));
+            } else {
+                index_count = vertex_count;
+                fill_sequential(reinterpret_cast<uint32_t *>(di), index_count, static_cast<uint32_t>(vertex_offset));
+            }
+            if (mirrored) {
+                for (size_t k = 0; k + 2 < index_count; k += 3) {
+                    std::swap(di[k + 1], di[k + 2]);
+                }
+            }
+
+            vertex_offset += vertex_count;
+            index_offset += index_count;
+        }
+        input_triangles += index_offset / 3;
+
+        Array merged;
+        merged.resize(Mesh::ARRAY_MAX);
+        merged[Mesh::ARRAY_VERTEX] = vertices;
+        merged[Mesh::ARRAY_INDEX] = indices;
+        if (keep[Mesh::ARRAY_NORMAL]) merged[Mesh::ARRAY_NORMAL] = normals;
+        if (keep[Mesh::ARRAY_TANGENT]) merged[Mesh::ARRAY_TANGENT] = tangents;
+        if (keep[Mesh::ARRAY_COLOR]) merged[Mesh::ARRAY_COLOR] = colors;
+        if (keep[Mesh::ARRAY_TEX_UV]) merged[Mesh::ARRAY_TEX_UV] = uvs;
+        if (keep[Mesh::ARRAY_TEX_UV2]) merged[Mesh::ARRAY_TEX_UV2] = uv2s;
+
+        if (weld) {
+            merged = optimize_surface(merged, OPTIMIZE_WELD);
+        }
+        if (target_ratio < 1.0f) {
+            merged = _simplify_mesh_arrays(merged, target_ratio, target_error, attribute_weights, true, params);
+        }
+        merged = optimize_surface(merged, OPTIMIZE_VERTEX_CACHE | OPTIMIZE_OVERDRAW | OPTIMIZE_VERTEX_FETCH);
+        output_triangles += PackedInt32Array(merged[Mesh::ARRAY_INDEX]).size() / 3;
+
+        Dictionary entry;
+        entry["material"] = group.material;
+        entry["arrays"] = merged;
+        entry["source_count"] = static_cast<int64_t>(group.members.size());
+        if (view_orders) {
+            const PackedVector3Array merged_vertices = merged[Mesh::ARRAY_VERTEX];
+            std::vector<float> scratch;
+            size_t cluster_count = 0;
+            entry["view_directions"] = directions;
+            entry["view_orders"] = view_ordered_indices(merged[Mesh::ARRAY_INDEX], float_stream(merged_vertices.ptr(), merged_vertices.size(), scratch),
+                merged_vertices.size(), directions, cluster_count);
+        }
+        result.push_back(entry);
     }
+    // Nested entry points only count as part of this call, so the totals are set last
+    call.triangles(input_triangles, output_triangles);
 
     return result;
 }
 
-Dictionary MeshOptimizerGD::simplify_sloppy(
-    PackedVector3Array vertices,
-    PackedInt32Array indices,
-    float target_ratio,
-    float target_error
-) {
+Dictionary MeshOptimizerGD::get_allocator_stats() {
+    mesh_arena::Stats stats = mesh_arena::get_stats();
+
     Dictionary result;
+    result["installed"] = mesh_arena::is_installed();
+    result["arena_allocations"] = static_cast<int64_t>(stats.arena_allocations);
+    result["arena_bytes"] = static_cast<int64_t>(stats.arena_bytes);
+    result["heap_allocations"] = static_cast<int64_t>(stats.heap_allocations);
+    result["heap_bytes"] = static_cast<int64_t>(stats.heap_bytes);
+    result["chunk_allocations"] = static_cast<int64_t>(stats.chunk_allocations);
+    result["chunk_bytes"] = static_cast<int64_t>(stats.chunk_bytes);
+    result["rewinds"] = static_cast<int64_t>(stats.rewinds);
+    return result;
+}
 
-    if (vertices.size() == 0 || indices.size() == 0) {
-        result["error"] = "Empty input";
-        return result;
-    }
+void MeshOptimizerGD::reset_allocator_stats() {
+    mesh_arena::reset_stats();
+}
 
-    size_t vertex_count = vertices.size();
-    size_t index_count = indices.size();
-    size_t target_index_count = static_cast<size_t>(index_count * target_ratio);
+Dictionary MeshOptimizerGD::get_stats() {
+    mesh_stats::Stats stats = mesh_stats::get_stats();
+    mesh_arena::Stats allocator = mesh_arena::get_stats();
 
-    if (target_index_count < 3) target_index_count = 3;
+    Dictionary result;
+    result["calls"] = static_cast<int64_t>(stats.calls);
+    result["triangles_in"] = static_cast<int64_t>(stats.triangles_in);
+    result["triangles_out"] = static_cast<int64_t>(stats.triangles_out);
+    result["total_nsec"] = static_cast<int64_t>(stats.total_nsec);
+    result["kernel_nsec"] = static_cast<int64_t>(stats.kernel_nsec);
+    result["convert_nsec"] = static_cast<int64_t>(stats.total_nsec > stats.kernel_nsec ? stats.total_nsec - stats.kernel_nsec : 0);
+    result["allocations"] = static_cast<int64_t>(allocator.arena_allocations + allocator.heap_allocations);
+    result["allocated_bytes"] = static_cast<int64_t>(allocator.arena_bytes + allocator.heap_bytes);
+    result["threads"] = static_cast<int64_t>(stats.threads);
+    return result;
+}
 
-    // Convert to raw arrays
-    std::vector<float> vertex_data(vertex_count * 3);
-    for (size_t i = 0; i < vertex_count; i++) {
-        Vector3 v = vertices[i];
-        vertex_data[i * 3 + 0] = v.x;
-        vertex_data[i * 3 + 1] = v.y;
-        vertex_data[i * 3 + 2] = v.z;
-    }
+void MeshOptimizerGD::reset_stats() {
+    mesh_stats::reset_stats();
+    mesh_arena::reset_stats();
+}
 
-    std::vector<unsigned int> index_data(index_count);
-    for (size_t i = 0; i < index_count; i++) {
-        index_data[i] = static_cast<unsigned int>(indices[i]);
+void MeshOptimizerGD::register_performance_monitors() {
+    // Not there yet when extensions initialize, and gone in some tool runs
+    if (!Engine::get_singleton()->has_singleton("Performance")) {
+        return;
     }
 
-    // Output buffer
-    std::vector<unsigned int> simplified_indices(index_count);
-    float result_error = 0.0f;
-
-    // Run sloppy simplification (faster, ignores topology)
-    size_t new_index_count = meshopt_simplifySloppy(
-        simplified_indices.data(),
-        index_data.data(),
-        index_count,
-        vertex_data.data(),
-        vertex_count,
-        sizeof(float) * 3,
-        target_index_count,
-        target_error,
-        &result_error
-    );
+    Performance *performance = Performance::get_singleton();
+    for (const PerformanceMonitor &monitor : PERFORMANCE_MONITORS) {
+        if (!performance->has_custom_monitor(monitor.id)) {
+            performance->add_custom_monitor(monitor.id, callable_mp_static(monitor.value));
+        }
+    }
+}
 
-    // Convert back
-    PackedInt32Array new_indices;
-    new_indices.resize(new_index_count);
-    for (size_t i = 0; i < new_index_count; i++) {
-        new_indices[i] = static_cast<int32_t>(simplified_indices[i]);
+void MeshOptimizerGD::unregister_performance_monitors() {
+    if (!Engine::get_singleton()->has_singleton("Performance")) {
+        return;
     }
 
-    result["indices"] = new_indices;
-    result["vertices"] = vertices;
-    result["result_error"] = result_error;
-    result["original_triangles"] = static_cast<int>(index_count / 3);
-    result["simplified_triangles"] = static_cast<int>(new_index_count / 3);
+    Performance *performance = Performance::get_singleton();
+    for (const PerformanceMonitor &monitor : PERFORMANCE_MONITORS) {
+        if (performance->has_custom_monitor(monitor.id)) {
+            performance->remove_custom_monitor(monitor.id);
+        }
+    }
+}
 
-    return result;
+int64_t MeshOptimizerGD::get_peak_memory_usage() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<int64_t>(counters.PeakWorkingSetSize);
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<int64_t>(usage.ru_maxrss); // Bytes
+#else
+    return static_cast<int64_t>(usage.ru_maxrss) * 1024; // Kilobytes
+#endif
+#endif
 }
 
-Array MeshOptimizerGD::simplify_mesh_arrays(Array mesh_arrays, float target_ratio, float target_error) {
-    Array result;
+Dictionary MeshOptimizerGD::build_impostor_cards(const Array &mesh_arrays, const Dictionary &options) {
+    mesh_stats::Call call;
+
+    Dictionary result;
 
     if (mesh_arrays.size() < Mesh::ARRAY_MAX) {
-        UtilityFunctions::push_error("MeshOptimizerGD: Invalid mesh arrays size");
+        result["error"] = "Invalid mesh arrays size";
         return result;
     }
 
     Variant v_vertices = mesh_arrays[Mesh::ARRAY_VERTEX];
     Variant v_indices = mesh_arrays[Mesh::ARRAY_INDEX];
-
     if (v_vertices.get_type() != Variant::PACKED_VECTOR3_ARRAY ||
         v_indices.get_type() != Variant::PACKED_INT32_ARRAY) {
-        UtilityFunctions::push_error("MeshOptimizerGD: Missing vertices or indices");
+        result["error"] = "Missing vertices or indices";
         return result;
     }
 
-    PackedVector3Array vertices = v_vertices;
-    PackedInt32Array indices = v_indices;
-
+    const PackedVector3Array vertices = v_vertices;
+    const PackedInt32Array indices = v_indices;
     if (vertices.size() == 0 || indices.size() == 0) {
-        return mesh_arrays; // Return original if empty
+        result["error"] = "Empty input";
+        return result;
     }
 
-    // Check for UVs
-    PackedVector2Array uvs;
-    Variant v_uvs = mesh_arrays[Mesh::ARRAY_TEX_UV];
-    bool has_uvs = v_uvs.get_type() == Variant::PACKED_VECTOR2_ARRAY;
-    if (has_uvs) {
-        uvs = v_uvs;
+    if (!valid_triangle_indices(indices, vertices.size())) {
+        result["error"] = "Indices out of range or not a triangle list";
+        return result;
     }
 
-    // Simplify
-    Dictionary simplified;
-    if (has_uvs && uvs.size() == vertices.size()) {
-        simplified = simplify_with_attributes(vertices, indices, uvs, target_ratio, target_error, 1.0f);
-    } else {
-        simplified = simplify(vertices, indices, target_ratio, target_error);
-    }
+    int card_vertices = CLAMP(static_cast<int>(options.get("card_vertices", 8)), 3, 16);
 
-    if (simplified.has("error")) {
-        UtilityFunctions::push_warning("MeshOptimizerGD: ", simplified["error"]);
-        return mesh_arrays;
+    // Only referenced vertices contribute to the silhouette
+    size_t vertex_count = vertices.size();
+    std::vector<unsigned char> used(vertex_count, 0);
+    for (int64_t i = 0; i < indices.size(); i++) {
+        used[indices[i]] = 1;
     }
 
-    // Build result arrays
-    result.resize(Mesh::ARRAY_MAX);
+    AABB aabb;
+    bool first = true;
+    for (size_t i = 0; i < vertex_count; i++) {
+        if (!used[i]) {
+            continue;
+        }
+        if (first) {
+            aabb = AABB(vertices[i], Vector3());
+            first = false;
+        } else {
+            aabb.expand_to(vertices[i]);
+        }
+    }
+    Vector3 center = aabb.position + aabb.size * 0.5f;
+
+    // Normal cones per meshlet tell which views only see back faces
+    Dictionary meshlets = build_meshlets(mesh_arrays);
+    const PackedVector3Array cone_axes = meshlets.get("cone_axes", PackedVector3Array());
+    const PackedFloat32Array cone_cutoffs = meshlets.get("cone_cutoffs", PackedFloat32Array());
+    const PackedInt32Array meshlet_index_counts = meshlets.get("index_counts", PackedInt32Array());
+
+    PackedVector3Array directions = options.get("directions", PackedVector3Array());
+    bool derived = directions.size() == 0;
+    float coverage = 0.0f;
+    if (derived) {
+        // A meshlet is seen most face-on from -axis (see the back-facing test below); meshlets
+        // with no usable cone (cutoff 1) face every way and are left out of the coverage
+        std::vector<mesh_impostor::ClusterFacing> clusters;
+        for (int64_t m = 0; m < cone_axes.size(); m++) {
+            Vector3 front = -cone_axes[m].normalized();
+            if (cone_cutoffs[m] < 1.0f && front.length_squared() > 0) {
+                clusters.push_back({ { static_cast<float>(front.x), static_cast<float>(front.y), static_cast<float>(front.z) },
+                    static_cast<float>(meshlet_index_counts[m]) });
+            }
+        }
 
-    // Copy original vertices (simplification reuses them via indices)
-    result[Mesh::ARRAY_VERTEX] = simplified["vertices"];
-    result[Mesh::ARRAY_INDEX] = simplified["indices"];
+        int max_directions = CLAMP(static_cast<int>(options.get("max_directions", 16)), 1, 64);
+        float target_coverage = CLAMP(static_cast<float>(options.get("coverage", 0.95f)), 0.0f, 1.0f);
+        float degrees = static_cast<float>(Math_PI) / 180.0f;
+        float max_view_angle = CLAMP(static_cast<float>(options.get("max_view_angle", 60.0f)), 1.0f, 90.0f) * degrees;
+        float min_separation = CLAMP(static_cast<float>(options.get("min_separation", 22.5f)), 0.0f, 90.0f) * degrees;
 
-    // Preserve other attributes from original
-    if (has_uvs) {
-        result[Mesh::ARRAY_TEX_UV] = mesh_arrays[Mesh::ARRAY_TEX_UV];
+        std::vector<mesh_impostor::Direction3> picks = mesh_impostor::select_capture_directions(clusters, max_directions,
+            target_coverage, max_view_angle, min_separation, coverage);
+        for (const mesh_impostor::Direction3 &pick : picks) {
+            directions.push_back(Vector3(pick.x, pick.y, pick.z));
+        }
+    }
+    if (directions.size() == 0) {
+        derived = false;
+        // Nothing to derive from: horizontal ring at 22.5 degree steps, the 16-frame atlas layout
+        for (int i = 0; i < 16; i++) {
+            float angle = i * static_cast<float>(Math_PI) / 8.0f;
+            directions.push_back(Vector3(std::sin(angle), 0.0f, std::cos(angle)));
+        }
     }
 
-    // Preserve normals if present
-    Variant v_normals = mesh_arrays[Mesh::ARRAY_NORMAL];
-    if (v_normals.get_type() == Variant::PACKED_VECTOR3_ARRAY) {
-        result[Mesh::ARRAY_NORMAL] = v_normals;
+    Array frames;
+    PackedVector3Array culled;
+    std::vector<mesh_impostor::Point2> projected;
+    projected.reserve(vertex_count);
+
+    for (int64_t d = 0; d < directions.size(); d++) {
+        Vector3 direction = directions[d].normalized();
+        if (direction.length_squared() == 0) {
+            continue;
+        }
+
+        // meshoptimizer cones assume counter-clockwise front faces while Godot's are clockwise, so
+        // with the ortho view looking along -direction a meshlet is back-facing when
+        // dot(-view, axis) = dot(direction, axis) >= cutoff
+        int64_t visible_indices = 0;
+        for (int64_t m = 0; m < cone_axes.size(); m++) {
+            if (direction.dot(cone_axes[m]) < cone_cutoffs[m]) {
+                visible_indices += meshlet_index_counts[m];
+            }
+        }
+        float visible_fraction = static_cast<float>(visible_indices) / indices.size();
+        if (cone_axes.size() > 0 && visible_indices == 0) {
+            culled.push_back(direction);
+            continue;
+        }
+
+        // Capture camera basis, matching Camera3D (x right, y up, z back towards the viewer)
+        Vector3 up_reference = std::abs(direction.y) > 0.999f ? Vector3(0, 0, -1) : Vector3(0, 1, 0);
+        Vector3 right = up_reference.cross(direction).normalized();
+        Vector3 up = direction.cross(right);
+
+        projected.clear();
+        for (size_t i = 0; i < vertex_count; i++) {
+            if (used[i]) {
+                Vector3 offset = vertices[i] - center;
+                projected.push_back({ static_cast<float>(offset.dot(right)), static_cast<float>(offset.dot(up)) });
+            }
+        }
+
+        std::vector<mesh_impostor::Point2> hull = mesh_impostor::convex_hull(projected);
+        if (hull.size() < 3) {
+            culled.push_back(direction); // Seen edge-on, nothing to capture
+            continue;
+        }
+        std::vector<mesh_impostor::Point2> card = mesh_impostor::fit_card(hull, card_vertices);
+
+        float min_x = card[0].x, max_x = card[0].x, min_y = card[0].y, max_y = card[0].y;
+        for (const mesh_impostor::Point2 &p : card) {
+            min_x = MIN(min_x, p.x);
+            max_x = MAX(max_x, p.x);
+            min_y = MIN(min_y, p.y);
+            max_y = MAX(max_y, p.y);
+        }
+        float width = MAX(max_x - min_x, 1e-6f);
+        float height = MAX(max_y - min_y, 1e-6f);
+
+        PackedVector3Array card_positions;
+        PackedVector2Array card_2d;
+        PackedVector2Array card_uvs;
+        for (const mesh_impostor::Point2 &p : card) {
+            card_positions.push_back(center + right * p.x + up * p.y);
+            card_2d.push_back(Vector2(p.x, p.y));
+            card_uvs.push_back(Vector2((p.x - min_x) / width, 1.0f - (p.y - min_y) / height));
+        }
+
+        // Hull points are counter-clockwise as seen by the camera, Godot front faces are clockwise
+        PackedInt32Array card_indices;
+        for (int i = 1; i + 1 < static_cast<int>(card.size()); i++) {
+            card_indices.push_back(0);
+            card_indices.push_back(i + 1);
+            card_indices.push_back(i);
+        }
+
+        float card_area = mesh_impostor::polygon_area(card);
+
+        Dictionary frame;
+        frame["direction"] = direction;
+        frame["right"] = right;
+        frame["up"] = up;
+        frame["rect"] = Rect2(min_x, min_y, width, height);
+        frame["card"] = card_positions;
+        frame["card_2d"] = card_2d;
+        frame["uvs"] = card_uvs;
+        frame["indices"] = card_indices;
+        frame["card_area_ratio"] = card_area / (width * height);
+        frame["hull_area_ratio"] = card_area > 0.0f ? mesh_impostor::polygon_area(hull) / card_area : 0.0f;
+        frame["visible_fraction"] = visible_fraction;
+        frames.push_back(frame);
     }
 
-    // Preserve colors if present
-    Variant v_colors = mesh_arrays[Mesh::ARRAY_COLOR];
-    if (v_colors.get_type() == Variant::PACKED_COLOR_ARRAY) {
-        result[Mesh::ARRAY_COLOR] = v_colors;
+    // Set after the nested build_meshlets call, which records its own count
+    call.triangles(indices.size() / 3, indices.size() / 3);
+
+    result["aabb"] = aabb;
+    result["center"] = center;
+    result["radius"] = aabb.size.length() * 0.5f;
+    result["frames"] = frames;
+    result["culled_directions"] = culled;
+    if (derived) {
+        result["coverage"] = coverage;
     }
 
     return result;
 }
 
-PackedInt32Array MeshOptimizerGD::optimize_vertex_cache(PackedInt32Array indices, int vertex_count) {
-    if (indices.size() == 0 || vertex_count <= 0) {
-        return indices;
+Dictionary MeshOptimizerGD::build_collision_proxy(const Array &mesh_arrays, int max_triangles, float target_error, const Dictionary &options) {
+    mesh_stats::Call call;
+
+    Dictionary result;
+
+    if (mesh_arrays.size() < Mesh::ARRAY_MAX) {
+        result["error"] = "Invalid mesh arrays size";
+        return result;
+    }
+
+    Variant v_vertices = mesh_arrays[Mesh::ARRAY_VERTEX];
+    if (v_vertices.get_type() != Variant::PACKED_VECTOR3_ARRAY || PackedVector3Array(v_vertices).size() == 0) {
+        result["error"] = "Missing vertices";
+        return result;
+    }
+    if (max_triangles < 1) {
+        result["error"] = "max_triangles must be at least 1";
+        return result;
     }
 
+    const PackedVector3Array vertices = v_vertices;
+    size_t vertex_count = vertices.size();
+    PackedInt32Array indices = surface_indices(mesh_arrays[Mesh::ARRAY_INDEX], vertex_count);
+    if (!valid_triangle_indices(indices, vertex_count)) {
+        result["error"] = "Indices out of range or not a triangle list";
+        return result;
+    }
     size_t index_count = indices.size();
-    std::vector<unsigned int> index_data(index_count);
-    for (size_t i = 0; i < index_count; i++) {
-        index_data[i] = static_cast<unsigned int>(indices[i]);
+
+    std::vector<float> position_scratch;
+    const float *positions = float_stream(vertices.ptr(), vertex_count, position_scratch);
+
+    SimplifyOptions simplify_options;
+    build_simplify_options(options, positions, vertex_count, simplify_options);
+
+    // Collision only sees positions, so UV and normal seams are welded before simplifying;
+    // without them the simplifier would keep every seam as a locked border
+    PackedInt32Array welded;
+    welded.resize(index_count);
+    {
+        mesh_stats::Kernel kernel;
+        meshopt_generateShadowIndexBuffer(
+            index_stream_w(welded),
+            index_stream(indices),
+            index_count,
+            positions,
+            vertex_count,
+            sizeof(float) * 3,
+            float_stride<Vector3>()
+        );
     }
 
-    std::vector<unsigned int> optimized(index_count);
-    meshopt_optimizeVertexCache(
-        optimized.data(),
-        index_data.data(),
-        index_count,
-        static_cast<size_t>(vertex_count)
-    );
+    size_t target_index_count = static_cast<size_t>(max_triangles) * 3;
+    PackedInt32Array proxy_indices;
+    float result_error = 0.0f;
+    bool sloppy = false;
 
-    PackedInt32Array result;
-    result.resize(index_count);
-    for (size_t i = 0; i < index_count; i++) {
-        result[i] = static_cast<int32_t>(optimized[i]);
+    if (index_count <= target_index_count) {
+        proxy_indices = welded;
+    } else {
+        proxy_indices.resize(index_count);
+        size_t new_index_count = simplify_indices(
+            index_stream_w(proxy_indices),
+            index_stream(welded),
+            index_count,
+            positions,
+            vertex_count,
+            AttributeStream(),
+            target_index_count,
+            target_error,
+            simplify_options,
+            &result_error
+        );
+
+        // The error bound (or locked seams) stopped it short; the budget wins for collision
+        if (new_index_count > target_index_count && bool(options.get("sloppy", true))) {
+            mesh_stats::Kernel kernel;
+            new_index_count = meshopt_simplifySloppy(
+                index_stream_w(proxy_indices),
+                index_stream(welded),
+                index_count,
+                positions,
+                vertex_count,
+                float_stride<Vector3>(),
+                target_index_count,
+                FLT_MAX,
+                &result_error
+            );
+            sloppy = true;
+        }
+        proxy_indices.resize(new_index_count);
+    }
+    size_t proxy_index_count = proxy_indices.size();
+    call.triangles(index_count / 3, proxy_index_count / 3);
+
+    size_t unique_count = 0;
+    PackedInt32Array remap = build_fetch_remap(proxy_indices, vertex_count, unique_count);
+    meshopt_remapIndexBuffer(index_stream_w(proxy_indices), index_stream(proxy_indices), proxy_index_count, index_stream(remap));
+
+    PackedVector3Array points;
+    remap_packed_into(points, vertices, vertex_count, unique_count, remap);
+
+    PackedVector3Array faces;
+    faces.resize(proxy_index_count);
+    Vector3 *fw = faces.ptrw();
+    const Vector3 *pr = points.ptr();
+    const int32_t *ir = proxy_indices.ptr();
+    for (size_t i = 0; i < proxy_index_count; i++) {
+        fw[i] = pr[ir[i]];
     }
 
+    // The sloppy simplifier always reports relative errors
+    bool absolute = !sloppy && (simplify_options.flags & meshopt_SimplifyErrorAbsolute);
+    float scale = absolute ? 1.0f : meshopt_simplifyScale(positions, vertex_count, float_stride<Vector3>());
+
+    result["faces"] = faces;
+    result["points"] = points;
+    result["indices"] = proxy_indices;
+    result["triangles"] = static_cast<int>(proxy_index_count / 3);
+    result["original_triangles"] = static_cast<int>(index_count / 3);
+    result["result_error"] = result_error;
+    result["world_error"] = result_error * scale;
+    result["sloppy"] = sloppy;
+
     return result;
 }
 
-Dictionary MeshOptimizerGD::weld_vertices(
-    PackedVector3Array vertices,
-    PackedInt32Array indices,
-    float threshold
-) {
+Dictionary MeshOptimizerGD::build_view_orders(const Array &mesh_arrays, const Dictionary &options) {
+    mesh_stats::Call call;
+
     Dictionary result;
 
-    if (vertices.size() == 0) {
-        result["error"] = "Empty vertices";
+    if (mesh_arrays.size() < Mesh::ARRAY_MAX) {
+        result["error"] = "Invalid mesh arrays size";
         return result;
     }
 
-    size_t vertex_count = vertices.size();
+    Variant v_vertices = mesh_arrays[Mesh::ARRAY_VERTEX];
+    Variant v_indices = mesh_arrays[Mesh::ARRAY_INDEX];
 
-    // Convert vertices
-    std::vector<float> vertex_data(vertex_count * 3);
-    for (size_t i = 0; i < vertex_count; i++) {
-        Vector3 v = vertices[i];
-        vertex_data[i * 3 + 0] = v.x;
-        vertex_data[i * 3 + 1] = v.y;
-        vertex_data[i * 3 + 2] = v.z;
-    }
-
-    // Generate remap table
-    std::vector<unsigned int> remap(vertex_count);
-    size_t unique_count = meshopt_generateVertexRemap(
-        remap.data(),
-        indices.size() > 0 ? reinterpret_cast<unsigned int*>(const_cast<int32_t*>(indices.ptr())) : nullptr,
-        indices.size() > 0 ? indices.size() : vertex_count,
-        vertex_data.data(),
-        vertex_count,
-        sizeof(float) * 3
-    );
+    if (v_vertices.get_type() != Variant::PACKED_VECTOR3_ARRAY ||
+        v_indices.get_type() != Variant::PACKED_INT32_ARRAY) {
+        result["error"] = "Missing vertices or indices";
+        return result;
+    }
 
-    // Apply remap to create new vertex buffer
-    PackedVector3Array new_vertices;
-    new_vertices.resize(unique_count);
+    const PackedVector3Array vertices = v_vertices;
+    const PackedInt32Array indices = v_indices;
 
-    std::vector<float> remapped_vertices(unique_count * 3);
-    meshopt_remapVertexBuffer(
-        remapped_vertices.data(),
-        vertex_data.data(),
-        vertex_count,
-        sizeof(float) * 3,
-        remap.data()
-    );
+    if (vertices.size() == 0 || indices.size() == 0) {
+        result["error"] = "Empty input";
+        return result;
+    }
 
-    for (size_t i = 0; i < unique_count; i++) {
-        new_vertices[i] = Vector3(
-            remapped_vertices[i * 3 + 0],
-            remapped_vertices[i * 3 + 1],
-            remapped_vertices[i * 3 + 2]
-        );
+    size_t vertex_count = vertices.size();
+    if (!valid_triangle_indices(indices, vertex_count)) {
+        result["error"] = "Indices out of range or not a triangle list";
+        return result;
     }
 
-    // Remap indices if provided
-    PackedInt32Array new_indices;
-    if (indices.size() > 0) {
-        new_indices.resize(indices.size());
-        for (int i = 0; i < indices.size(); i++) {
-            new_indices[i] = static_cast<int32_t>(remap[indices[i]]);
+    std::vector<float> position_scratch;
+    const float *positions = float_stream(vertices.ptr(), vertex_count, position_scratch);
+
+    PackedVector3Array directions = view_directions(options);
+    size_t cluster_count = 0;
+    Array orders = view_ordered_indices(indices, positions, vertex_count, directions, cluster_count);
+    call.triangles(indices.size() / 3, indices.size() / 3);
+
+    result["directions"] = directions;
+    result["orders"] = orders;
+    result["cluster_count"] = static_cast<int64_t>(cluster_count);
+    return result;
+}
+
+int MeshOptimizerGD::select_view_order(const PackedVector3Array &directions, const Vector3 &to_camera) {
+    int best = -1;
+    real_t best_dot = 0.0f;
+    for (int64_t i = 0; i < directions.size(); i++) {
+        real_t dot = directions[i].dot(to_camera);
+        if (best < 0 || dot > best_dot) {
+            best = static_cast<int>(i);
+            best_dot = dot;
         }
     }
+    return best;
+}
 
-    result["vertices"] = new_vertices;
-    result["indices"] = new_indices;
-    result["original_count"] = static_cast<int>(vertex_count);
-    result["unique_count"] = static_cast<int>(unique_count);
+void MeshOptimizerGD::configure_cache(int64_t max_bytes, const String &directory) {
+    mesh_cache::configure(static_cast<uint64_t>(std::max<int64_t>(max_bytes, 0)), directory);
+}
+
+void MeshOptimizerGD::clear_cache() {
+    mesh_cache::clear();
+}
+
+Dictionary MeshOptimizerGD::get_cache_stats() {
+    mesh_cache::Stats stats = mesh_cache::get_stats();
+
+    Dictionary result;
+    result["hits"] = static_cast<int64_t>(stats.hits);
+    result["disk_hits"] = static_cast<int64_t>(stats.disk_hits);
+    result["misses"] = static_cast<int64_t>(stats.misses);
+    result["evictions"] = static_cast<int64_t>(stats.evictions);
+    result["entries"] = static_cast<int64_t>(stats.entries);
+    result["bytes"] = static_cast<int64_t>(stats.bytes);
+    result["max_bytes"] = static_cast<int64_t>(stats.max_bytes);
+    return result;
+}
 
+PackedByteArray MeshOptimizerGD::pack_indices16(const PackedInt32Array &indices) {
+    PackedByteArray result;
+    result.resize(indices.size() * sizeof(uint16_t));
+    if (!narrow_indices(reinterpret_cast<uint16_t *>(result.ptrw()), index_stream(indices), indices.size())) {
+        UtilityFunctions::push_error("MeshOptimizerGD: pack_indices16 needs indices below 65536");
+        return PackedByteArray();
+    }
+    return result;
+}
+
+PackedInt32Array MeshOptimizerGD::unpack_indices16(const PackedByteArray &data) {
+    PackedInt32Array result;
+    if (data.size() % sizeof(uint16_t) != 0) {
+        UtilityFunctions::push_error("MeshOptimizerGD: 16-bit index data has an odd size");
+        return result;
+    }
+    size_t index_count = data.size() / sizeof(uint16_t);
+    result.resize(index_count);
+    widen_indices(reinterpret_cast<uint32_t *>(result.ptrw()), reinterpret_cast<const uint16_t *>(data.ptr()), index_count);
     return result;
 }
 
@@ -3,69 +3,376 @@
 #ifndef MESHOPTIMIZER_GDEXT_H
 #define MESHOPTIMIZER_GDEXT_H
 
+#include <godot_cpp/classes/mesh.hpp>
 #include <godot_cpp/classes/ref_counted.hpp>
 #include <godot_cpp/variant/packed_vector3_array.hpp>
 #include <godot_cpp/variant/packed_int32_array.hpp>
 #include <godot_cpp/variant/packed_vector2_array.hpp>
+#include <godot_cpp/variant/packed_float32_array.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
 #include <godot_cpp/variant/array.hpp>
 #include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/transform3d.hpp>
+
+#include "meshoptimizer_result.h"
 
 namespace godot {
 
+// Every method is static and reentrant: calls keep their state on the stack, so any number of
+// threads (WorkerThreadPool tasks, MeshOptimizerBatch workers) may call MeshOptimizerGD.simplify(...)
+// and friends at once without an instance or a lock. The shared parts synchronize themselves:
+// the result cache behind a mutex, stats and the scratch arena per thread.
+// Callers keep two rules: inputs may be shared between calls but not modified while one runs,
+// and a MeshOptimizerResult belongs to one *_into call at a time. The performance monitors
+// are registered from the main thread. Scripts that create an instance keep working.
 class MeshOptimizerGD : public RefCounted {
     GDCLASS(MeshOptimizerGD, RefCounted)
 
+public:
+    // optimize_surface passes, run in this order
+    enum OptimizeFlags {
+        OPTIMIZE_WELD = 1, // Merge vertices identical in every array
+        OPTIMIZE_VERTEX_CACHE = 2,
+        OPTIMIZE_OVERDRAW = 4,
+        OPTIMIZE_VERTEX_FETCH = 8, // Reorder (and compact) vertices by first use
+        OPTIMIZE_ALL = 15,
+    };
+
+    // Simplifier flags, matching meshopt_SimplifyX
+    enum SimplifyFlags {
+        SIMPLIFY_LOCK_BORDER = 1, // Keep vertices on open borders, so independently simplified chunks still stitch
+        SIMPLIFY_SPARSE = 2, // Indices are a small subset of the vertex buffer; error becomes relative to the subset
+        SIMPLIFY_ERROR_ABSOLUTE = 4, // target_error and result_error are in mesh units instead of relative
+    };
+
 protected:
     static void _bind_methods();
 
+private:
+    // Uncached implementations behind the cached entry points of the same name
+    static Array _simplify_mesh_arrays(const Array &mesh_arrays, float target_ratio, float target_error, const Dictionary &attribute_weights, bool compact_vertices, const Dictionary &options);
+    static Array _generate_lod_chain(const Array &mesh_arrays, const PackedFloat32Array &ratios, float target_error, const Dictionary &attribute_weights, const Dictionary &options);
+    static Array _generate_lod_chain_by_error(const Array &mesh_arrays, const PackedFloat32Array &world_errors, const Dictionary &attribute_weights, float min_ratio, const Dictionary &options);
+    static Array _merge_surfaces(const Array &surfaces, const Array &transforms, const Dictionary &params);
+
+    // Container decoding over raw bytes, shared with MeshOptimizerMappedFile
+    friend class MeshOptimizerMappedFile;
+    static Array _decode_surface(const uint8_t *data, size_t size, int surface_index);
+    static Array _decode_surfaces(const uint8_t *data, size_t size);
+    static Dictionary _get_progressive_info(const uint8_t *data, size_t size);
+    static Array _decode_progressive(const uint8_t *data, size_t size, int level);
+
 public:
     MeshOptimizerGD();
     ~MeshOptimizerGD();
 
     // Simplify mesh to target ratio (0.0-1.0)
+    // compact_vertices drops unreferenced vertices and adds "remap" (old -> new index, -1 = dropped)
+    // so callers can compact their other per-vertex arrays the same way
     // Returns: Dictionary with "vertices", "indices", "uvs" (if present), "result_error"
-    Dictionary simplify(
-        PackedVector3Array vertices,
-        PackedInt32Array indices,
+    static Dictionary simplify(
+        const PackedVector3Array &vertices,
+        const PackedInt32Array &indices,
         float target_ratio,
-        float target_error = 0.01f
+        float target_error = 0.01f,
+        bool compact_vertices = false
     );
 
     // Simplify mesh with UV preservation
-    Dictionary simplify_with_attributes(
-        PackedVector3Array vertices,
-        PackedInt32Array indices,
-        PackedVector2Array uvs,
+    // vertex_lock: optional, one byte per vertex, non-zero vertices are never moved or removed
+    // simplify_flags: SimplifyFlags bitmask
+    static Dictionary simplify_with_attributes(
+        const PackedVector3Array &vertices,
+        const PackedInt32Array &indices,
+        const PackedVector2Array &uvs,
         float target_ratio,
         float target_error = 0.01f,
-        float uv_weight = 1.0f
+        float uv_weight = 1.0f,
+        bool compact_vertices = false,
+        const PackedByteArray &vertex_lock = PackedByteArray(),
+        int simplify_flags = 0
     );
 
     // Sloppy simplification (faster, ignores topology)
-    Dictionary simplify_sloppy(
-        PackedVector3Array vertices,
-        PackedInt32Array indices,
+    static Dictionary simplify_sloppy(
+        const PackedVector3Array &vertices,
+        const PackedInt32Array &indices,
         float target_ratio,
-        float target_error = 0.01f
+        float target_error = 0.01f,
+        bool compact_vertices = false
     );
 
+    // Typed variants of simplify / simplify_with_attributes / simplify_sloppy that write into a
+    // reusable MeshOptimizerResult instead of building a Dictionary per call
+    // Returns: false (with result.get_error()) on invalid input
+    static bool simplify_into(
+        const PackedVector3Array &vertices,
+        const PackedInt32Array &indices,
+        float target_ratio,
+        float target_error,
+        bool compact_vertices,
+        const Ref<MeshOptimizerResult> &result
+    );
+    static bool simplify_with_attributes_into(
+        const PackedVector3Array &vertices,
+        const PackedInt32Array &indices,
+        const PackedVector2Array &uvs,
+        float target_ratio,
+        float target_error,
+        float uv_weight,
+        bool compact_vertices,
+        const PackedByteArray &vertex_lock,
+        int simplify_flags,
+        const Ref<MeshOptimizerResult> &result
+    );
+    static bool simplify_sloppy_into(
+        const PackedVector3Array &vertices,
+        const PackedInt32Array &indices,
+        float target_ratio,
+        float target_error,
+        bool compact_vertices,
+        const Ref<MeshOptimizerResult> &result
+    );
+
+    // Pick a spatially representative subset of points, e.g. scatter instances for distant rings
+    // colors: optional, one per point; color_weight sets how much color variety is preserved vs coverage
+    // Returns: Dictionary with "indices" (kept points into the input), "positions", "colors" (if given)
+    static Dictionary simplify_points(const PackedVector3Array &positions, const PackedColorArray &colors, int target_count, float color_weight = 1.0f);
+
+    // Order points along a space-filling curve, e.g. MultiMesh instance origins
+    // Returns: remap with old -> new positions, so new_buffer[remap[i]] = old_buffer[i]
+    static PackedInt32Array spatial_sort_points(const PackedVector3Array &positions);
+
+    // Reorder the triangles of a surface for spatial locality (cheaper partial culling on merged
+    // meshes); vertices are unchanged, non-indexed surfaces get an index buffer
+    // Returns: Mesh arrays with the new ARRAY_INDEX
+    static Array spatial_sort_triangles(const Array &mesh_arrays);
+
     // Simplify Godot mesh arrays directly
     // Input: Standard Godot mesh arrays (from surface_get_arrays)
+    // attribute_weights: Mesh.ArrayType -> weight for ARRAY_TEX_UV, ARRAY_TEX_UV2, ARRAY_NORMAL,
+    //   ARRAY_TANGENT and ARRAY_COLOR, packed into one attribute stream (empty = UVs at 1.0)
+    // compact_vertices drops vertices the simplified indices no longer use from every array
+    // options: "flags" (SimplifyFlags), "vertex_lock" (PackedByteArray, one per vertex) and
+    //   "lock_aabb" (AABB, locks vertices within "lock_tolerance" of its faces, e.g. the cell bounds)
+    //   and "cache" (default true, set false to bypass configure_cache for this call)
     // Returns: Simplified mesh arrays ready for surface_add_arrays
-    Array simplify_mesh_arrays(Array mesh_arrays, float target_ratio, float target_error = 0.01f);
+    static Array simplify_mesh_arrays(const Array &mesh_arrays, float target_ratio, float target_error = 0.01f, const Dictionary &attribute_weights = Dictionary(), bool compact_vertices = true, const Dictionary &options = Dictionary());
+
+    // Generate a LOD chain from Godot mesh arrays in one call
+    // Each level is simplified from the previous level's indices; ratios are relative to the input
+    // Returns: Array of Dictionaries with "indices", "result_error" (accumulated), "world_error" (in mesh units), "ratio", "triangles"
+    // All levels reference the input vertex arrays, so they can be passed as surface LODs directly
+    // attribute_weights, options: as for simplify_mesh_arrays
+    static Array generate_lod_chain(const Array &mesh_arrays, const PackedFloat32Array &ratios, float target_error = 0.01f, const Dictionary &attribute_weights = Dictionary(), const Dictionary &options = Dictionary());
+
+    // Generate LODs bounded by a world-space error instead of a triangle ratio
+    // world_errors: maximum deviation per level in mesh units, ascending; min_ratio keeps at least
+    //   that fraction of the triangles per level
+    // Each level is simplified from the full mesh, so its error is exact rather than accumulated
+    // Returns: Array of Dictionaries with "indices", "result_error" (relative), "world_error", "ratio", "triangles"
+    static Array generate_lod_chain_by_error(const Array &mesh_arrays, const PackedFloat32Array &world_errors, const Dictionary &attribute_weights = Dictionary(), float min_ratio = 0.0f, const Dictionary &options = Dictionary());
+
+    // Scale that converts relative simplification errors into mesh units (meshopt_simplifyScale)
+    static float get_simplify_scale(const PackedVector3Array &vertices);
+
+    // Distance beyond which world_error projects to less than pixel_error pixels for a
+    // perspective camera with the given vertical fov and viewport height
+    static float get_lod_switch_distance(float world_error, float viewport_height, float fov_degrees = 75.0f, float pixel_error = 1.0f);
 
     // Optimize vertex cache (improves GPU performance)
-    PackedInt32Array optimize_vertex_cache(PackedInt32Array indices, int vertex_count);
+    static PackedInt32Array optimize_vertex_cache(const PackedInt32Array &indices, int vertex_count);
 
     // Weld vertices (merge duplicates within threshold)
-    Dictionary weld_vertices(
-        PackedVector3Array vertices,
-        PackedInt32Array indices,
+    static Dictionary weld_vertices(
+        const PackedVector3Array &vertices,
+        const PackedInt32Array &indices,
         float threshold = 0.0001f
     );
 
+    // Typed variant of weld_vertices; original/unique counts are get_original_vertex_count()
+    // and get_vertex_count()
+    static bool weld_vertices_into(
+        const PackedVector3Array &vertices,
+        const PackedInt32Array &indices,
+        float threshold,
+        const Ref<MeshOptimizerResult> &result
+    );
+
+    // Run the GPU-ready pipeline on Godot mesh arrays in one call
+    // Weld considers every per-vertex array, so normal/UV seams are kept
+    // Non-indexed surfaces come back indexed
+    // Returns: Optimized mesh arrays ready for surface_add_arrays
+    static Array optimize_surface(const Array &mesh_arrays, int flags = OPTIMIZE_ALL, float overdraw_threshold = 1.05f);
+
+    // Fit impostor cards to the silhouette of a surface for each capture direction
+    // options: "directions" (PackedVector3Array from the object towards the camera), "card_vertices"
+    //   (3-16, default 8; 4 gives tight quads)
+    // Without "directions" the capture set is derived: candidates are the bounds axes and the meshlet
+    //   normal cones' front directions, picked greedily by the triangles they see within
+    //   "max_view_angle" (degrees, default 60) until "coverage" (default 0.95) or "max_directions"
+    //   (default 16), no two closer than "min_separation" (degrees, default 22.5). The greedy pick is
+    //   not a minimal set. Meshlets with no usable cone are not counted; if none has one, the
+    //   16-frame horizontal ring is used. Directions from which every meshlet is back-facing are dropped
+    // Returns: Dictionary with "aabb", "center", "radius", "culled_directions", "coverage" (fraction
+    //   of cone triangles reached, only for a derived set) and "frames", each with
+    //   "direction", capture basis "right"/"up", "rect" (capture area in that basis around "center"),
+    //   "card" (object space polygon), "card_2d", "uvs" (0-1 over rect), "indices", "card_area_ratio"
+    //   (card / rect, overdraw saved vs a full quad), "hull_area_ratio" and "visible_fraction"
+    static Dictionary build_impostor_cards(const Array &mesh_arrays, const Dictionary &options = Dictionary());
+
+    // Index orders of a surface for a few view directions, each with the same triangles clustered
+    // into meshlets and sorted front to back, for overlapping geometry where fill rate dominates;
+    // the renderer swaps in the order of the direction nearest its camera (select_view_order)
+    // options: "view_directions" (PackedVector3Array, object towards camera) or a ring of "view_count"
+    //   (default 8) directions raised by "view_elevation" degrees (default 20)
+    // Returns: Dictionary with "directions", "orders" (one PackedInt32Array per direction, on the
+    //   input vertices) and "cluster_count"
+    static Dictionary build_view_orders(const Array &mesh_arrays, const Dictionary &options = Dictionary());
+    // Index of the direction closest to to_camera (object towards camera), -1 if there are none
+    static int select_view_order(const PackedVector3Array &directions, const Vector3 &to_camera);
+
+    // Compact collision geometry for a surface in one call: vertices are welded by position only,
+    // simplified towards max_triangles within target_error and, if that stops short, simplified
+    // sloppily to the budget
+    // options: the simplify_mesh_arrays "flags", "vertex_lock", "lock_aabb" (keep cell seams closed,
+    //   ignored by the sloppy fallback) and "sloppy" (default true, false keeps the error bound)
+    // Returns: Dictionary with "faces" (for ConcavePolygonShape3D.set_faces), "points" (the proxy
+    //   vertices, for ConvexPolygonShape3D), "indices", "triangles", "original_triangles",
+    //   "result_error", "world_error" and "sloppy" (the fallback ran)
+    static Dictionary build_collision_proxy(const Array &mesh_arrays, int max_triangles = 256, float target_error = 0.01f, const Dictionary &options = Dictionary());
+
+    // Index buffer for depth-only passes: vertices that differ only in normals/UVs share one index
+    // position_only: returns a compact position-only surface for ArrayMesh.shadow_mesh; otherwise the
+    //   input arrays with shadow indices, sharing the original vertex buffer
+    // Triangles are vertex cache optimized either way
+    static Array generate_shadow_indices(const Array &mesh_arrays, bool position_only = true);
+
+    // Split a surface into meshlets (clusters) for cluster culling
+    // max_vertices <= 255, max_triangles <= 512 (rounded down to a multiple of 4); cone_weight 0-1
+    // trades cluster compactness for tighter normal cones
+    // Returns: Dictionary with "indices" (surface indices regrouped so each meshlet is a contiguous
+    //   range), per-meshlet "index_offsets"/"index_counts", bounding "spheres" (x, y, z, radius),
+    //   "aabb_positions"/"aabb_sizes", "cone_apexes", "cone_axes", "cone_cutoffs" (cos of half angle)
+    static Dictionary build_meshlets(const Array &mesh_arrays, int max_vertices = 64, int max_triangles = 124, float cone_weight = 0.25f);
+
+    // Encode surfaces into a compact binary container (meshopt vertex/index codecs)
+    // options: "normal_bits" (0 = lossless, else octahedral normals/tangents with 1-16 bits),
+    //   "float_bits" (0 = lossless, else mantissa bits kept for float arrays, 1-24)
+    // Index buffers compress best after optimize_surface
+    static PackedByteArray encode_surface(const Array &mesh_arrays, const Dictionary &options = Dictionary());
+    static PackedByteArray encode_surfaces(const Array &surfaces, const Dictionary &options = Dictionary());
+
+    // Decode surfaces from an encode_surface(s) container; safe to call from worker threads
+    // Returns: Mesh arrays ready for surface_add_arrays (empty on malformed data)
+    static Array decode_surface(const PackedByteArray &data, int surface_index = 0);
+    static Array decode_surfaces(const PackedByteArray &data);
+    static int get_encoded_surface_count(const PackedByteArray &data);
+
+    // Encode a surface progressively: simplified levels (generate_lod_chain) coarsest first, then
+    // the full mesh, so a prefix of the data decodes to a coarse version and reading further refines it
+    // ratios: coarse levels relative to the input (empty = 0.0625, 0.125, 0.25, 0.5); levels that do
+    //   not reduce further are dropped
+    // options: the encode_surface options, "target_error" (default 0.01), "attribute_weights" and the
+    //   simplify_mesh_arrays options; the surface must be indexed
+    static PackedByteArray encode_progressive(const Array &mesh_arrays, const PackedFloat32Array &ratios = PackedFloat32Array(), const Dictionary &options = Dictionary());
+    // Header of progressive data, or of a prefix at least "header_bytes" long
+    // Returns: Dictionary with "levels" (Dictionaries with "bytes", the prefix size that level needs,
+    //   "vertices", "triangles" and "world_error"), "loaded_levels" (complete in data), "vertex_count"
+    //   and "header_bytes"; "error" (and "header_bytes" once the first 12 bytes are there) on failure
+    static Dictionary get_progressive_info(const PackedByteArray &data);
+    // Decode one level (-1 = the finest complete in data) of progressive data or a prefix of it;
+    // safe to call from worker threads
+    // Returns: Mesh arrays ready for surface_add_arrays (empty if the level is not loaded or on malformed data)
+    static Array decode_progressive(const PackedByteArray &data, int level = -1);
+
+    // Build the native surface buffers so RenderingServer.mesh_add_surface(mesh, data) skips the
+    // validation and conversion of add_surface_from_arrays; safe to call from worker threads
+    // lods: Dictionaries with "indices" and "world_error" (generate_lod_chain output) for the surface LODs
+    // Custom arrays, 2D vertices and attribute compression are not supported (use add_surface_from_arrays)
+    // Returns: surface Dictionary ("format", "vertex_data", "attribute_data", "skin_data", "index_data",
+    //   "aabb", "lods", "bone_aabbs", ...), or one with "error" on failure
+    static Dictionary build_surface_data(const Array &mesh_arrays, const Array &lods = Array(), int primitive = Mesh::PRIMITIVE_TRIANGLES);
+
+    // Quantize a surface for the distant tiers and report the resulting accuracy
+    // options: "format" = "compressed" (Godot ARRAY_FLAG_COMPRESS_ATTRIBUTES precision: 16-bit positions
+    //   over the AABB, 16-bit UVs over their range, octahedral normals), "half" (fp16) or "float"
+    //   (fp32 with "float_bits" mantissa bits, default 10; compresses better with encode_surface)
+    //   "max_position_error" (world units), "max_normal_error" (degrees), "max_uv_error"; <= 0 disables a gate
+    // Returns: Dictionary with "arrays" (values snapped to what the GPU will see), "accepted" (all gates
+    //   passed), "flags" (surface flags to pass to add_surface_from_arrays), "report" (max/avg errors)
+    //   and, for "half", "half_streams" (Mesh.ArrayType -> PackedByteArray of fp16, Vector3 padded to 4)
+    static Dictionary quantize_surface(const Array &mesh_arrays, const Dictionary &options = Dictionary());
+
+    // Estimate the GPU cost of a surface with the meshoptimizer analyzers
+    // Returns: Dictionary with "acmr" and "atvr" (vertex cache, FIFO model with cache_size entries),
+    //   "overdraw" (shaded / covered pixels), "overfetch" (fetched bytes / vertex buffer size)
+    //   plus the raw counters, "vertex_count", "triangle_count" and "vertex_size"
+    static Dictionary analyze_surface(const Array &mesh_arrays, int cache_size = 16);
+
+    // Analyze every triangle surface of the Mesh resources under path (recursive)
+    // thresholds: optional "max_acmr", "max_atvr", "max_overdraw", "max_overfetch"
+    // report_path: optional .csv or .json file to write the report to
+    // Returns: Dictionary with "entries" (per-surface analysis plus "path", "surface" and "failed"
+    //   metric names, most transformed vertices first), "failed_count" and "passed"
+    static Dictionary analyze_directory(const String &path, const String &report_path = "", const Dictionary &thresholds = Dictionary());
+
+    // Transform, concatenate, weld, simplify and optimize many surfaces into one surface per material
+    // transforms: one Transform3D per surface (missing entries use the identity)
+    // params: "materials" (one key per surface; equal keys are merged, default: everything in one group),
+    //   "target_ratio" (default 1.0, no simplification), "target_error", "attribute_weights", "weld" (default true)
+    //   the simplify_mesh_arrays options ("flags", "lock_aabb", "lock_tolerance", "cache") and
+    //   "view_orders" (default false) with the build_view_orders options
+    // Only vertex, normal, tangent, color and UV arrays present on every surface of a group are kept
+    // Returns: Array of Dictionaries with "material", "arrays", "source_count" and, with view_orders,
+    //   "view_directions" and "view_orders"
+    static Array merge_surfaces(const Array &surfaces, const Array &transforms, const Dictionary &params = Dictionary());
+
+    // Counters of the per-thread scratch arena meshoptimizer allocates from
+    // Returns: Dictionary with "installed", "arena_allocations", "arena_bytes", "heap_allocations",
+    //   "heap_bytes" (requests that did not fit an arena), "chunk_allocations", "chunk_bytes", "rewinds"
+    static Dictionary get_allocator_stats();
+    static void reset_allocator_stats();
+
+    // Peak resident set size of the process in bytes (0 where the platform does not report it)
+    static int64_t get_peak_memory_usage();
+
+    // Totals across all threads since the last reset_stats(), for telling native cost apart
+    // from the script around it
+    // Returns: Dictionary with "calls", "triangles_in", "triangles_out", "total_nsec", "kernel_nsec"
+    //   (inside meshopt_*), "convert_nsec" (the rest: validation, conversion, result marshalling),
+    //   "allocations"/"allocated_bytes" (meshoptimizer scratch) and "threads"
+    static Dictionary get_stats();
+    // Also resets the allocation counters of get_allocator_stats()
+    static void reset_stats();
+
+    // Performance custom monitors ("MeshOptimizer/...") over get_stats(), added on the first
+    // frame by the module initializer and removed at shutdown
+    static void register_performance_monitors();
+    static void unregister_performance_monitors();
+
+    // Content-hashed cache of simplify_mesh_arrays, generate_lod_chain(_by_error) and merge_surfaces
+    // results, keyed by every argument, so unchanged surfaces are not simplified again on the next
+    // prebake run. Disabled until configured.
+    // max_bytes: memory budget of the LRU (0 disables caching); directory: optional folder the
+    //   entries are also written to and read back from after a restart
+    // Resource arguments (merge_surfaces "materials") are keyed by resource_path; calls with other
+    //   objects are not cached, and results holding materials are not written to the directory
+    static void configure_cache(int64_t max_bytes, const String &directory = "");
+    // Drops the in-memory entries; files in the cache directory are kept
+    static void clear_cache();
+    // Returns: Dictionary with "hits", "disk_hits" (part of hits), "misses", "evictions", "entries",
+    //   "bytes" and "max_bytes". Cache hits are not counted as calls in get_stats()
+    static Dictionary get_cache_stats();
+
+    // Index buffers of surfaces under 65536 vertices at half the size, e.g. for LOD caches kept
+    // in memory or on disk (the RenderingServer already picks 16-bit indices itself on upload)
+    // Returns: native-endian uint16 data, empty if an index does not fit
+    static PackedByteArray pack_indices16(const PackedInt32Array &indices);
+    static PackedInt32Array unpack_indices16(const PackedByteArray &data);
+
     // Get library version
-    String get_version();
+    static String get_version();
 
     // Check if native library is available
     static bool is_available();
@@ -73,4 +380,7 @@ public:
 
 } // namespace godot
 
+VARIANT_ENUM_CAST(MeshOptimizerGD::OptimizeFlags);
+VARIANT_ENUM_CAST(MeshOptimizerGD::SimplifyFlags);
+
 #endif // MESHOPTIMIZER_GDEXT_H
@@ -0,0 +1,197 @@
+// MeshOptimizer GDExtension for Godot 4
+// Impostor card fitting: silhouette hulls and tight billboard polygons
+
+#include "meshoptimizer_impostor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace godot {
+namespace mesh_impostor {
+
+namespace {
+
+float cross(const Point2 &o, const Point2 &a, const Point2 &b) {
+    return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+// Collapsing edge (p1, p2) extends edges (p0, p1) and (p3, p2) until they meet at r_point
+// Returns the area added, or infinity when the extensions do not meet beyond the edge
+float collapse_cost(const Point2 &p0, const Point2 &p1, const Point2 &p2, const Point2 &p3, Point2 &r_point) {
+    float dx1 = p1.x - p0.x, dy1 = p1.y - p0.y;
+    float dx2 = p2.x - p3.x, dy2 = p2.y - p3.y;
+    float denominator = dx1 * dy2 - dy1 * dx2;
+    if (std::abs(denominator) < 1e-12f) {
+        return std::numeric_limits<float>::infinity();
+    }
+
+    // p0 + t * d1 = p3 + s * d2, both need t, s >= 1 to lie past p1 and p2
+    float ex = p3.x - p0.x, ey = p3.y - p0.y;
+    float t = (ex * dy2 - ey * dx2) / denominator;
+    float s = (ex * dy1 - ey * dx1) / denominator;
+    if (t < 1.0f || s < 1.0f) {
+        return std::numeric_limits<float>::infinity();
+    }
+
+    r_point.x = p0.x + t * dx1;
+    r_point.y = p0.y + t * dy1;
+    return 0.5f * std::abs(cross(p1, r_point, p2));
+}
+
+} // namespace
+
+std::vector<Point2> convex_hull(std::vector<Point2> points) {
+    std::sort(points.begin(), points.end(), [](const Point2 &a, const Point2 &b) {
+        return a.x < b.x || (a.x == b.x && a.y < b.y);
+    });
+    points.erase(std::unique(points.begin(), points.end(), [](const Point2 &a, const Point2 &b) {
+        return a.x == b.x && a.y == b.y;
+    }), points.end());
+
+    if (points.size() < 3) {
+        return points;
+    }
+
+    // Andrew's monotone chain
+    std::vector<Point2> hull(points.size() * 2);
+    size_t k = 0;
+    for (size_t i = 0; i < points.size(); i++) {
+        while (k >= 2 && cross(hull[k - 2], hull[k - 1], points[i]) <= 0.0f) {
+            k--;
+        }
+        hull[k++] = points[i];
+    }
+    for (size_t i = points.size() - 1, lower = k + 1; i > 0; i--) {
+        while (k >= lower && cross(hull[k - 2], hull[k - 1], points[i - 1]) <= 0.0f) {
+            k--;
+        }
+        hull[k++] = points[i - 1];
+    }
+    hull.resize(k - 1);
+
+    return hull;
+}
+
+std::vector<Point2> fit_card(const std::vector<Point2> &hull, int max_vertices) {
+    std::vector<Point2> polygon = hull;
+    size_t target = static_cast<size_t>(std::max(max_vertices, 3));
+
+    while (polygon.size() > target) {
+        size_t n = polygon.size();
+        float best_cost = std::numeric_limits<float>::infinity();
+        size_t best_edge = 0;
+        Point2 best_point;
+
+        for (size_t i = 0; i < n; i++) {
+            Point2 point;
+            float cost = collapse_cost(polygon[(i + n - 1) % n], polygon[i], polygon[(i + 1) % n], polygon[(i + 2) % n], point);
+            if (cost < best_cost) {
+                best_cost = cost;
+                best_edge = i;
+                best_point = point;
+            }
+        }
+
+        if (!std::isfinite(best_cost)) {
+            break;
+        }
+
+        // Replace the edge's two endpoints with the intersection point
+        size_t next = (best_edge + 1) % n;
+        polygon[best_edge] = best_point;
+        polygon.erase(polygon.begin() + next);
+    }
+
+    return polygon;
+}
+
+float polygon_area(const std::vector<Point2> &polygon) {
+    float area = 0.0f;
+    for (size_t i = 0, n = polygon.size(); i < n; i++) {
+        const Point2 &a = polygon[i];
+        const Point2 &b = polygon[(i + 1) % n];
+        area += a.x * b.y - b.x * a.y;
+    }
+    return 0.5f * std::abs(area);
+}
+
+std::vector<Direction3> select_capture_directions(const std::vector<ClusterFacing> &clusters, int max_count, float coverage,
+    float max_angle, float min_separation, float &r_coverage) {
+    const size_t max_candidate_clusters = 256;
+
+    std::vector<Direction3> candidates = {
+        { 0.0f, 0.0f, 1.0f }, { 1.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, -1.0f },
+        { -1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, -1.0f, 0.0f },
+    };
+
+    // Fronts of the heaviest clusters, which keeps the search linear in the cluster count
+    std::vector<size_t> order(clusters.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return clusters[a].weight > clusters[b].weight; });
+    if (order.size() > max_candidate_clusters) {
+        order.resize(max_candidate_clusters);
+    }
+    for (size_t i : order) {
+        candidates.push_back(clusters[i].front);
+    }
+
+    auto dot = [](const Direction3 &a, const Direction3 &b) { return a.x * b.x + a.y * b.y + a.z * b.z; };
+    float captured_cos = std::cos(max_angle);
+    float separation_cos = std::cos(min_separation);
+
+    float total_weight = 0.0f;
+    for (const ClusterFacing &cluster : clusters) {
+        total_weight += cluster.weight;
+    }
+
+    std::vector<Direction3> picks;
+    std::vector<unsigned char> captured(clusters.size(), 0);
+    float captured_weight = 0.0f;
+    while (static_cast<int>(picks.size()) < max_count && total_weight > 0.0f && captured_weight < coverage * total_weight) {
+        size_t best = candidates.size();
+        float best_gain = 0.0f;
+        for (size_t c = 0; c < candidates.size(); c++) {
+            bool separated = true;
+            for (const Direction3 &pick : picks) {
+                if (dot(pick, candidates[c]) > separation_cos) {
+                    separated = false;
+                    break;
+                }
+            }
+            if (!separated) {
+                continue;
+            }
+
+            float gain = 0.0f;
+            for (size_t i = 0; i < clusters.size(); i++) {
+                if (!captured[i] && dot(clusters[i].front, candidates[c]) >= captured_cos) {
+                    gain += clusters[i].weight;
+                }
+            }
+            if (gain > best_gain) {
+                best = c;
+                best_gain = gain;
+            }
+        }
+        if (best == candidates.size()) {
+            break;
+        }
+
+        picks.push_back(candidates[best]);
+        for (size_t i = 0; i < clusters.size(); i++) {
+            if (!captured[i] && dot(clusters[i].front, candidates[best]) >= captured_cos) {
+                captured[i] = 1;
+            }
+        }
+        captured_weight += best_gain;
+    }
+
+    r_coverage = total_weight > 0.0f ? captured_weight / total_weight : 0.0f;
+    return picks;
+}
+
+} // namespace mesh_impostor
+} // namespace godot
@@ -0,0 +1,51 @@
+// MeshOptimizer GDExtension for Godot 4
+// Impostor card fitting: silhouette hulls and tight billboard polygons
+#ifndef MESHOPTIMIZER_IMPOSTOR_H
+#define MESHOPTIMIZER_IMPOSTOR_H
+
+#include <cstddef>
+#include <vector>
+
+namespace godot {
+namespace mesh_impostor {
+
+struct Point2 {
+    float x = 0.0f;
+    float y = 0.0f;
+};
+
+// Convex hull of a point set, counter-clockwise without collinear points
+std::vector<Point2> convex_hull(std::vector<Point2> points);
+
+// Reduce a convex polygon to at most max_vertices (>= 3) by repeatedly collapsing the edge whose
+// removal grows the area least; the result is convex and still contains the input polygon.
+// Stops early when no edge can be collapsed (e.g. parallel neighbours).
+std::vector<Point2> fit_card(const std::vector<Point2> &hull, int max_vertices);
+
+float polygon_area(const std::vector<Point2> &polygon);
+
+struct Direction3 {
+    float x = 0.0f;
+    float y = 0.0f;
+    float z = 0.0f;
+};
+
+// A cluster of triangles by the direction its faces point (unit length) and its triangle count
+struct ClusterFacing {
+    Direction3 front;
+    float weight = 0.0f;
+};
+
+// Capture directions (object towards camera, unit length) that see most of the surface face-on.
+// A cluster counts as captured by a direction within max_angle (radians) of its front. Candidates
+// are the six bounds axes and the fronts of the heaviest clusters; each pick is the candidate
+// capturing the most weight not captured yet, at least min_separation away from earlier picks,
+// so the result is in order of importance. Stops after max_count picks, once coverage (0-1 of the
+// total weight) is reached, or when no candidate adds anything. r_coverage is the fraction reached.
+std::vector<Direction3> select_capture_directions(const std::vector<ClusterFacing> &clusters, int max_count, float coverage,
+    float max_angle, float min_separation, float &r_coverage);
+
+} // namespace mesh_impostor
+} // namespace godot
+
+#endif // MESHOPTIMIZER_IMPOSTOR_H
@@ -0,0 +1,184 @@
+// MeshOptimizer GDExtension for Godot 4
+// Read-only memory-mapped view of prebaked encode_surfaces / encode_progressive output
+
+#include "meshoptimizer_mapped.h"
+#include "meshoptimizer_gdext.h"
+#include "meshoptimizer_codec.h"
+
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/project_settings.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace godot;
+
+void MeshOptimizerMappedFile::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("open", "file_path"), &MeshOptimizerMappedFile::open);
+    ClassDB::bind_method(D_METHOD("close"), &MeshOptimizerMappedFile::close);
+    ClassDB::bind_method(D_METHOD("is_open"), &MeshOptimizerMappedFile::is_open);
+    ClassDB::bind_method(D_METHOD("is_mapped"), &MeshOptimizerMappedFile::is_mapped);
+    ClassDB::bind_method(D_METHOD("get_path"), &MeshOptimizerMappedFile::get_path);
+    ClassDB::bind_method(D_METHOD("get_size"), &MeshOptimizerMappedFile::get_size);
+    ClassDB::bind_method(D_METHOD("get_surface_count"), &MeshOptimizerMappedFile::get_surface_count);
+    ClassDB::bind_method(D_METHOD("decode_surface", "surface_index"),
+        &MeshOptimizerMappedFile::decode_surface, DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("decode_surfaces"), &MeshOptimizerMappedFile::decode_surfaces);
+    ClassDB::bind_method(D_METHOD("get_progressive_info"), &MeshOptimizerMappedFile::get_progressive_info);
+    ClassDB::bind_method(D_METHOD("decode_progressive", "level"),
+        &MeshOptimizerMappedFile::decode_progressive, DEFVAL(-1));
+    ClassDB::bind_method(D_METHOD("get_bytes", "offset", "length"), &MeshOptimizerMappedFile::get_bytes);
+}
+
+MeshOptimizerMappedFile::~MeshOptimizerMappedFile() {
+    close();
+}
+
+bool MeshOptimizerMappedFile::_map(const String &absolute_path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileW(reinterpret_cast<LPCWSTR>(absolute_path.utf16().get_data()), GENERIC_READ, FILE_SHARE_READ,
+        nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER file_size;
+    HANDLE file_mapping = nullptr;
+    if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0 && static_cast<uint64_t>(file_size.QuadPart) <= SIZE_MAX) {
+        file_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    }
+    // The mapping keeps the file open
+    CloseHandle(file);
+    if (file_mapping == nullptr) {
+        return false;
+    }
+
+    void *view = MapViewOfFile(file_mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        CloseHandle(file_mapping);
+        return false;
+    }
+
+    mapping = file_mapping;
+    data = static_cast<const uint8_t *>(view);
+    size = static_cast<size_t>(file_size.QuadPart);
+#else
+    int fd = ::open(absolute_path.utf8().get_data(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    void *view = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    // The mapping keeps the file open
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        return false;
+    }
+
+    data = static_cast<const uint8_t *>(view);
+    size = static_cast<size_t>(st.st_size);
+#endif
+    mapped = true;
+    return true;
+}
+
+bool MeshOptimizerMappedFile::open(const String &file_path) {
+    close();
+
+    if (!_map(ProjectSettings::get_singleton()->globalize_path(file_path))) {
+        // Packed or virtual files have no path the OS can map; read them the usual way
+        if (!FileAccess::file_exists(file_path)) {
+            UtilityFunctions::push_error("MeshOptimizerMappedFile: Cannot open ", file_path);
+            return false;
+        }
+        buffer = FileAccess::get_file_as_bytes(file_path);
+        data = buffer.ptr();
+        size = buffer.size();
+    }
+
+    path = file_path;
+    return true;
+}
+
+void MeshOptimizerMappedFile::close() {
+    if (mapped) {
+#ifdef _WIN32
+        UnmapViewOfFile(data);
+        CloseHandle(mapping);
+        mapping = nullptr;
+#else
+        munmap(const_cast<uint8_t *>(data), size);
+#endif
+    }
+
+    path = String();
+    data = nullptr;
+    size = 0;
+    mapped = false;
+    buffer = PackedByteArray();
+}
+
+bool MeshOptimizerMappedFile::is_open() const {
+    return !path.is_empty();
+}
+
+bool MeshOptimizerMappedFile::is_mapped() const {
+    return mapped;
+}
+
+String MeshOptimizerMappedFile::get_path() const {
+    return path;
+}
+
+int64_t MeshOptimizerMappedFile::get_size() const {
+    return static_cast<int64_t>(size);
+}
+
+int MeshOptimizerMappedFile::get_surface_count() const {
+    return mesh_codec::get_surface_count(data, size);
+}
+
+Array MeshOptimizerMappedFile::decode_surface(int surface_index) const {
+    return MeshOptimizerGD::_decode_surface(data, size, surface_index);
+}
+
+Array MeshOptimizerMappedFile::decode_surfaces() const {
+    return MeshOptimizerGD::_decode_surfaces(data, size);
+}
+
+Dictionary MeshOptimizerMappedFile::get_progressive_info() const {
+    return MeshOptimizerGD::_get_progressive_info(data, size);
+}
+
+Array MeshOptimizerMappedFile::decode_progressive(int level) const {
+    return MeshOptimizerGD::_decode_progressive(data, size, level);
+}
+
+PackedByteArray MeshOptimizerMappedFile::get_bytes(int64_t offset, int64_t length) const {
+    PackedByteArray result;
+
+    if (offset < 0 || length < 0 || static_cast<uint64_t>(offset) > size || static_cast<uint64_t>(length) > size - offset) {
+        UtilityFunctions::push_error("MeshOptimizerMappedFile: Range outside the file");
+        return result;
+    }
+
+    result.resize(length);
+    if (length > 0) {
+        memcpy(result.ptrw(), data + offset, length);
+    }
+    return result;
+}
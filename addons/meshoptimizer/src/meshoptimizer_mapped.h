@@ -0,0 +1,64 @@
+// MeshOptimizer GDExtension for Godot 4
+// Read-only memory-mapped view of prebaked encode_surfaces / encode_progressive output
+#ifndef MESHOPTIMIZER_MAPPED_H
+#define MESHOPTIMIZER_MAPPED_H
+
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/string.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace godot {
+
+// Maps a container file and decodes surfaces straight from the mapped pages, so streaming a
+// cell costs the pages its surfaces touch instead of a full read into a PackedByteArray first.
+// Progressive levels only fault in their prefix. Files the platform cannot map (inside a PCK,
+// on Android assets) are read with FileAccess instead; is_mapped() tells which.
+// Decoding is read-only and safe from worker threads; do not open() or close() meanwhile.
+class MeshOptimizerMappedFile : public RefCounted {
+    GDCLASS(MeshOptimizerMappedFile, RefCounted)
+
+    String path;
+    const uint8_t *data = nullptr;
+    size_t size = 0;
+    bool mapped = false;
+    PackedByteArray buffer; // Fallback when mapping is unavailable
+#ifdef _WIN32
+    void *mapping = nullptr;
+#endif
+
+    bool _map(const String &absolute_path);
+
+protected:
+    static void _bind_methods();
+
+public:
+    ~MeshOptimizerMappedFile();
+
+    // Accepts res://, user:// and absolute paths; pushes an error and returns false on failure
+    bool open(const String &file_path);
+    void close();
+
+    bool is_open() const;
+    bool is_mapped() const;
+    String get_path() const;
+    int64_t get_size() const;
+
+    // As the MeshOptimizerGD methods of the same name, reading from the file
+    int get_surface_count() const;
+    Array decode_surface(int surface_index = 0) const;
+    Array decode_surfaces() const;
+    Dictionary get_progressive_info() const;
+    Array decode_progressive(int level = -1) const;
+
+    // Copy of a byte range, e.g. to hand one surface to code that takes a PackedByteArray
+    PackedByteArray get_bytes(int64_t offset, int64_t length) const;
+};
+
+} // namespace godot
+
+#endif // MESHOPTIMIZER_MAPPED_H
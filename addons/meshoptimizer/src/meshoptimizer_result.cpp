@@ -0,0 +1,119 @@
+// MeshOptimizer GDExtension for Godot 4
+// Reusable typed result for the simplify/weld entry points
+
+#include "meshoptimizer_result.h"
+
+#include <godot_cpp/core/class_db.hpp>
+
+using namespace godot;
+
+void MeshOptimizerResult::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("is_ok"), &MeshOptimizerResult::is_ok);
+    ClassDB::bind_method(D_METHOD("get_error"), &MeshOptimizerResult::get_error);
+    ClassDB::bind_method(D_METHOD("get_vertices"), &MeshOptimizerResult::get_vertices);
+    ClassDB::bind_method(D_METHOD("get_indices"), &MeshOptimizerResult::get_indices);
+    ClassDB::bind_method(D_METHOD("get_uvs"), &MeshOptimizerResult::get_uvs);
+    ClassDB::bind_method(D_METHOD("get_remap"), &MeshOptimizerResult::get_remap);
+    ClassDB::bind_method(D_METHOD("get_result_error"), &MeshOptimizerResult::get_result_error);
+    ClassDB::bind_method(D_METHOD("get_original_triangles"), &MeshOptimizerResult::get_original_triangles);
+    ClassDB::bind_method(D_METHOD("get_simplified_triangles"), &MeshOptimizerResult::get_simplified_triangles);
+    ClassDB::bind_method(D_METHOD("get_original_vertex_count"), &MeshOptimizerResult::get_original_vertex_count);
+    ClassDB::bind_method(D_METHOD("get_vertex_count"), &MeshOptimizerResult::get_vertex_count);
+    ClassDB::bind_method(D_METHOD("get_kernel_usec"), &MeshOptimizerResult::get_kernel_usec);
+    ClassDB::bind_method(D_METHOD("to_dictionary"), &MeshOptimizerResult::to_dictionary);
+}
+
+void MeshOptimizerResult::_begin(Source new_source) {
+    source = new_source;
+    error = String();
+    has_uvs = false;
+    has_remap = false;
+    result_error = 0.0f;
+    original_triangles = 0;
+    simplified_triangles = 0;
+    original_vertex_count = 0;
+    vertex_count = 0;
+    kernel_usec = 0;
+}
+
+bool MeshOptimizerResult::_fail(const String &message) {
+    error = message;
+    return false;
+}
+
+bool MeshOptimizerResult::is_ok() const {
+    return error.is_empty();
+}
+
+String MeshOptimizerResult::get_error() const {
+    return error;
+}
+
+PackedVector3Array MeshOptimizerResult::get_vertices() const {
+    return vertices;
+}
+
+PackedInt32Array MeshOptimizerResult::get_indices() const {
+    return indices;
+}
+
+PackedVector2Array MeshOptimizerResult::get_uvs() const {
+    return has_uvs ? uvs : PackedVector2Array();
+}
+
+PackedInt32Array MeshOptimizerResult::get_remap() const {
+    return has_remap ? remap : PackedInt32Array();
+}
+
+float MeshOptimizerResult::get_result_error() const {
+    return result_error;
+}
+
+int MeshOptimizerResult::get_original_triangles() const {
+    return original_triangles;
+}
+
+int MeshOptimizerResult::get_simplified_triangles() const {
+    return simplified_triangles;
+}
+
+int MeshOptimizerResult::get_original_vertex_count() const {
+    return original_vertex_count;
+}
+
+int MeshOptimizerResult::get_vertex_count() const {
+    return vertex_count;
+}
+
+int64_t MeshOptimizerResult::get_kernel_usec() const {
+    return kernel_usec;
+}
+
+Dictionary MeshOptimizerResult::to_dictionary() const {
+    Dictionary result;
+
+    if (!error.is_empty()) {
+        result["error"] = error;
+        return result;
+    }
+
+    result["vertices"] = vertices;
+    result["indices"] = indices;
+    if (has_uvs) {
+        result["uvs"] = uvs;
+    }
+    if (has_remap) {
+        result["remap"] = remap;
+    }
+
+    if (source == SOURCE_WELD) {
+        result["original_count"] = original_vertex_count;
+        result["unique_count"] = vertex_count;
+    } else if (source == SOURCE_SIMPLIFY) {
+        result["result_error"] = result_error;
+        result["original_triangles"] = original_triangles;
+        result["simplified_triangles"] = simplified_triangles;
+    }
+
+    return result;
+}
@@ -0,0 +1,78 @@
+// MeshOptimizer GDExtension for Godot 4
+// Reusable typed result for the simplify/weld entry points
+#ifndef MESHOPTIMIZER_RESULT_H
+#define MESHOPTIMIZER_RESULT_H
+
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_vector2_array.hpp>
+#include <godot_cpp/variant/packed_vector3_array.hpp>
+#include <godot_cpp/variant/string.hpp>
+
+namespace godot {
+
+// Output of MeshOptimizerGD.*_into(); the same fields the Dictionary variants return, without
+// per-field boxing. Buffers are rewritten in place by the next call, so keeping one result per
+// loop avoids reallocating them while no caller holds a copy of a returned array.
+class MeshOptimizerResult : public RefCounted {
+    GDCLASS(MeshOptimizerResult, RefCounted)
+
+    friend class MeshOptimizerGD;
+
+    enum Source {
+        SOURCE_NONE,
+        SOURCE_SIMPLIFY,
+        SOURCE_WELD,
+    };
+
+    Source source = SOURCE_NONE;
+    String error;
+
+    PackedVector3Array vertices;
+    PackedInt32Array indices;
+    PackedVector2Array uvs;
+    PackedInt32Array remap;
+    bool has_uvs = false;
+    bool has_remap = false;
+
+    float result_error = 0.0f;
+    int original_triangles = 0;
+    int simplified_triangles = 0;
+    int original_vertex_count = 0;
+    int vertex_count = 0;
+    int64_t kernel_usec = 0;
+
+    // Start a new call: scalars and flags are reset, buffers are kept for reuse
+    void _begin(Source new_source);
+    bool _fail(const String &message);
+
+protected:
+    static void _bind_methods();
+
+public:
+    bool is_ok() const;
+    String get_error() const;
+
+    PackedVector3Array get_vertices() const;
+    PackedInt32Array get_indices() const;
+    // Empty unless the call had UVs
+    PackedVector2Array get_uvs() const;
+    // Old -> new vertex index (-1 = dropped); empty unless vertices were compacted
+    PackedInt32Array get_remap() const;
+
+    float get_result_error() const;
+    int get_original_triangles() const;
+    int get_simplified_triangles() const;
+    int get_original_vertex_count() const;
+    int get_vertex_count() const;
+    // Time spent in meshoptimizer itself; the rest of a call is argument and result marshalling
+    int64_t get_kernel_usec() const;
+
+    // Same layout as the Dictionary returned by the non-_into method that filled this result
+    Dictionary to_dictionary() const;
+};
+
+} // namespace godot
+
+#endif // MESHOPTIMIZER_RESULT_H
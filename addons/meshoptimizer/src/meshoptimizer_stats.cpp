@@ -0,0 +1,160 @@
+// MeshOptimizer GDExtension for Godot 4
+// Per-thread call counters for the MeshOptimizerGD entry points
+
+#include "meshoptimizer_stats.h"
+
+#include <atomic>
+#include <chrono>
+
+namespace godot {
+namespace mesh_stats {
+
+namespace {
+
+enum Counter {
+    COUNTER_CALLS,
+    COUNTER_TRIANGLES_IN,
+    COUNTER_TRIANGLES_OUT,
+    COUNTER_TOTAL_NSEC,
+    COUNTER_KERNEL_NSEC,
+    COUNTER_MAX,
+};
+
+// One per thread that ever recorded; only the owner adds, reset_stats() may store from outside
+struct Block {
+    std::atomic<uint64_t> values[COUNTER_MAX];
+    std::atomic<bool> in_use;
+    Block *next = nullptr;
+};
+
+// Blocks are never freed (one per concurrently counting thread), so readers can walk the
+// list without locking
+std::atomic<Block *> blocks(nullptr);
+
+Block *acquire_block() {
+    for (Block *block = blocks.load(std::memory_order_acquire); block; block = block->next) {
+        bool expected = false;
+        if (!block->in_use.load(std::memory_order_relaxed) &&
+                block->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            return block;
+        }
+    }
+
+    Block *block = new Block();
+    for (int i = 0; i < COUNTER_MAX; i++) {
+        block->values[i].store(0, std::memory_order_relaxed);
+    }
+    block->in_use.store(true, std::memory_order_relaxed);
+
+    Block *head = blocks.load(std::memory_order_relaxed);
+    do {
+        block->next = head;
+    } while (!blocks.compare_exchange_weak(head, block, std::memory_order_release, std::memory_order_relaxed));
+    return block;
+}
+
+struct ThreadState {
+    Block *block = nullptr;
+    int call_depth = 0;
+    int kernel_depth = 0;
+    uint64_t kernel_nsec = 0; // Of the current outermost Call
+    size_t triangles_in = 0;
+    size_t triangles_out = 0;
+
+    ~ThreadState() {
+        if (block) {
+            block->in_use.store(false, std::memory_order_release);
+        }
+    }
+
+    void add(Counter counter, uint64_t value) {
+        if (!block) {
+            block = acquire_block();
+        }
+        block->values[counter].fetch_add(value, std::memory_order_relaxed);
+    }
+};
+
+thread_local ThreadState thread_state;
+
+} // namespace
+
+uint64_t now_nsec() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+Stats get_stats() {
+    uint64_t totals[COUNTER_MAX] = {};
+    Stats stats;
+
+    for (Block *block = blocks.load(std::memory_order_acquire); block; block = block->next) {
+        for (int i = 0; i < COUNTER_MAX; i++) {
+            totals[i] += block->values[i].load(std::memory_order_relaxed);
+        }
+        stats.threads++;
+    }
+
+    stats.calls = totals[COUNTER_CALLS];
+    stats.triangles_in = totals[COUNTER_TRIANGLES_IN];
+    stats.triangles_out = totals[COUNTER_TRIANGLES_OUT];
+    stats.total_nsec = totals[COUNTER_TOTAL_NSEC];
+    stats.kernel_nsec = totals[COUNTER_KERNEL_NSEC];
+    return stats;
+}
+
+void reset_stats() {
+    // Calls in flight on other threads still add their totals afterwards
+    for (Block *block = blocks.load(std::memory_order_acquire); block; block = block->next) {
+        for (int i = 0; i < COUNTER_MAX; i++) {
+            block->values[i].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+Call::Call() {
+    ThreadState &state = thread_state;
+    outermost = state.call_depth++ == 0;
+    start = 0;
+    if (outermost) {
+        state.kernel_nsec = 0;
+        state.triangles_in = 0;
+        state.triangles_out = 0;
+        start = now_nsec();
+    }
+}
+
+Call::~Call() {
+    ThreadState &state = thread_state;
+    state.call_depth--;
+    if (!outermost) {
+        return;
+    }
+
+    state.add(COUNTER_CALLS, 1);
+    state.add(COUNTER_TRIANGLES_IN, state.triangles_in);
+    state.add(COUNTER_TRIANGLES_OUT, state.triangles_out);
+    state.add(COUNTER_TOTAL_NSEC, now_nsec() - start);
+    state.add(COUNTER_KERNEL_NSEC, state.kernel_nsec);
+}
+
+void Call::triangles(size_t in, size_t out) {
+    thread_state.triangles_in = in;
+    thread_state.triangles_out = out;
+}
+
+Kernel::Kernel() {
+    outermost = thread_state.kernel_depth++ == 0;
+    start = outermost ? now_nsec() : 0;
+}
+
+Kernel::~Kernel() {
+    ThreadState &state = thread_state;
+    state.kernel_depth--;
+    if (outermost) {
+        state.kernel_nsec += now_nsec() - start;
+    }
+}
+
+} // namespace mesh_stats
+} // namespace godot
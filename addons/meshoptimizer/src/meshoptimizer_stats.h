@@ -0,0 +1,62 @@
+// MeshOptimizer GDExtension for Godot 4
+// Per-thread call counters for the MeshOptimizerGD entry points
+#ifndef MESHOPTIMIZER_STATS_H
+#define MESHOPTIMIZER_STATS_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace godot {
+namespace mesh_stats {
+
+// Every thread counts into its own block, so recording is an uncontended relaxed add; readers
+// sum all blocks. Blocks outlive their thread and are handed to the next thread that starts
+// counting, so totals survive worker pools being torn down and recreated.
+
+struct Stats {
+    uint64_t calls = 0;
+    uint64_t triangles_in = 0;
+    uint64_t triangles_out = 0;
+    uint64_t total_nsec = 0; // Whole entry point, including kernel_nsec
+    uint64_t kernel_nsec = 0; // Inside meshopt_* calls; the rest is conversion and marshalling
+    uint64_t threads = 0; // Threads that have recorded anything
+};
+
+Stats get_stats();
+void reset_stats();
+
+uint64_t now_nsec();
+
+// Times one public entry point. Only the outermost Call on a thread records, so entry points
+// that forward to each other count once; triangles() may be called from any of them.
+class Call {
+    uint64_t start;
+    bool outermost;
+
+public:
+    Call();
+    ~Call();
+
+    void triangles(size_t in, size_t out);
+
+    Call(const Call &) = delete;
+    Call &operator=(const Call &) = delete;
+};
+
+// Times a meshoptimizer kernel inside a Call
+class Kernel {
+    uint64_t start;
+    bool outermost;
+
+public:
+    Kernel();
+    ~Kernel();
+
+    Kernel(const Kernel &) = delete;
+    Kernel &operator=(const Kernel &) = delete;
+};
+
+} // namespace mesh_stats
+} // namespace godot
+
+#endif // MESHOPTIMIZER_STATS_H
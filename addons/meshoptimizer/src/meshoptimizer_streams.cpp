@@ -0,0 +1,159 @@
+// MeshOptimizer GDExtension for Godot 4
+// Conversion kernels for handing Godot packed arrays to meshoptimizer
+
+#include "meshoptimizer_streams.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STREAMS_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define STREAMS_NEON
+#include <arm_neon.h>
+#endif
+
+namespace godot {
+namespace mesh_streams {
+
+void convert_floats(float *dst, const double *src, size_t count) {
+    size_t i = 0;
+#if defined(STREAMS_SSE2)
+    for (; i + 4 <= count; i += 4) {
+        __m128 lo = _mm_cvtpd_ps(_mm_loadu_pd(src + i));
+        __m128 hi = _mm_cvtpd_ps(_mm_loadu_pd(src + i + 2));
+        _mm_storeu_ps(dst + i, _mm_movelh_ps(lo, hi));
+    }
+#elif defined(STREAMS_NEON)
+    for (; i + 4 <= count; i += 4) {
+        float32x2_t lo = vcvt_f32_f64(vld1q_f64(src + i));
+        float32x2_t hi = vcvt_f32_f64(vld1q_f64(src + i + 2));
+        vst1q_f32(dst + i, vcombine_f32(lo, hi));
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] = static_cast<float>(src[i]);
+    }
+}
+
+void convert_floats(double *dst, const float *src, size_t count) {
+    size_t i = 0;
+#if defined(STREAMS_SSE2)
+    for (; i + 4 <= count; i += 4) {
+        __m128 v = _mm_loadu_ps(src + i);
+        _mm_storeu_pd(dst + i, _mm_cvtps_pd(v));
+        _mm_storeu_pd(dst + i + 2, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+    }
+#elif defined(STREAMS_NEON)
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t v = vld1q_f32(src + i);
+        vst1q_f64(dst + i, vcvt_f64_f32(vget_low_f32(v)));
+        vst1q_f64(dst + i + 2, vcvt_high_f64_f32(v));
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] = static_cast<double>(src[i]);
+    }
+}
+
+void fill_sequential(uint32_t *dst, size_t count, uint32_t first) {
+    size_t i = 0;
+#if defined(STREAMS_SSE2)
+    __m128i value = _mm_add_epi32(_mm_set1_epi32(static_cast<int>(first)), _mm_setr_epi32(0, 1, 2, 3));
+    const __m128i step = _mm_set1_epi32(4);
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), value);
+        value = _mm_add_epi32(value, step);
+    }
+#elif defined(STREAMS_NEON)
+    static const uint32_t lanes[4] = { 0, 1, 2, 3 };
+    uint32x4_t value = vaddq_u32(vdupq_n_u32(first), vld1q_u32(lanes));
+    const uint32x4_t step = vdupq_n_u32(4);
+    for (; i + 4 <= count; i += 4) {
+        vst1q_u32(dst + i, value);
+        value = vaddq_u32(value, step);
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] = first + static_cast<uint32_t>(i);
+    }
+}
+
+void offset_indices(uint32_t *dst, const uint32_t *src, size_t count, uint32_t offset) {
+    size_t i = 0;
+#if defined(STREAMS_SSE2)
+    const __m128i add = _mm_set1_epi32(static_cast<int>(offset));
+    for (; i + 4 <= count; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_add_epi32(v, add));
+    }
+#elif defined(STREAMS_NEON)
+    const uint32x4_t add = vdupq_n_u32(offset);
+    for (; i + 4 <= count; i += 4) {
+        vst1q_u32(dst + i, vaddq_u32(vld1q_u32(src + i), add));
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] = src[i] + offset;
+    }
+}
+
+bool narrow_indices(uint16_t *dst, const uint32_t *src, size_t count) {
+    size_t i = 0;
+#if defined(STREAMS_SSE2)
+    // SSE2 only packs with signed saturation, so bias into the int16 range and back
+    const __m128i bias32 = _mm_set1_epi32(0x8000);
+    const __m128i bias16 = _mm_set1_epi16(static_cast<short>(0x8000));
+    __m128i high = _mm_setzero_si128();
+    for (; i + 8 <= count; i += 8) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 4));
+        high = _mm_or_si128(high, _mm_or_si128(_mm_srli_epi32(a, 16), _mm_srli_epi32(b, 16)));
+        __m128i packed = _mm_packs_epi32(_mm_sub_epi32(a, bias32), _mm_sub_epi32(b, bias32));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_add_epi16(packed, bias16));
+    }
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(high, _mm_setzero_si128())) != 0xFFFF) {
+        return false;
+    }
+#elif defined(STREAMS_NEON)
+    uint32x4_t high = vdupq_n_u32(0);
+    for (; i + 8 <= count; i += 8) {
+        uint32x4_t a = vld1q_u32(src + i);
+        uint32x4_t b = vld1q_u32(src + i + 4);
+        high = vorrq_u32(high, vorrq_u32(vshrq_n_u32(a, 16), vshrq_n_u32(b, 16)));
+        vst1q_u16(dst + i, vcombine_u16(vmovn_u32(a), vmovn_u32(b)));
+    }
+    if (vmaxvq_u32(high) != 0) {
+        return false;
+    }
+#endif
+    for (; i < count; i++) {
+        if (src[i] > 0xFFFF) {
+            return false;
+        }
+        dst[i] = static_cast<uint16_t>(src[i]);
+    }
+    return true;
+}
+
+void widen_indices(uint32_t *dst, const uint16_t *src, size_t count) {
+    size_t i = 0;
+#if defined(STREAMS_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= count; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_unpacklo_epi16(v, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i + 4), _mm_unpackhi_epi16(v, zero));
+    }
+#elif defined(STREAMS_NEON)
+    for (; i + 8 <= count; i += 8) {
+        uint16x8_t v = vld1q_u16(src + i);
+        vst1q_u32(dst + i, vmovl_u16(vget_low_u16(v)));
+        vst1q_u32(dst + i + 4, vmovl_high_u16(v));
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] = src[i];
+    }
+}
+
+} // namespace mesh_streams
+} // namespace godot
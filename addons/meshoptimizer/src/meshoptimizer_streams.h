@@ -0,0 +1,79 @@
+// MeshOptimizer GDExtension for Godot 4
+// Internal helpers for handing Godot packed arrays to meshoptimizer
+#ifndef MESHOPTIMIZER_STREAMS_H
+#define MESHOPTIMIZER_STREAMS_H
+
+#include <godot_cpp/variant/packed_int32_array.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace godot {
+namespace mesh_streams {
+
+static_assert(sizeof(int32_t) == sizeof(unsigned int), "Index buffers are passed to meshoptimizer in place");
+
+// Bulk conversion kernels for the copies that cannot be avoided (meshoptimizer_streams.cpp).
+// SSE2 on x86-64 and NEON on ARM64 are baseline there, so they are picked at compile time;
+// other targets use the scalar loops. The loops stream through memory once, so wider vectors
+// would not make them faster.
+void convert_floats(float *dst, const double *src, size_t count);
+void convert_floats(double *dst, const float *src, size_t count);
+
+// dst[i] = first + i, the trivial index buffer of a non-indexed surface
+void fill_sequential(uint32_t *dst, size_t count, uint32_t first = 0);
+
+// dst[i] = src[i] + offset, for concatenating index buffers; dst may be src
+void offset_indices(uint32_t *dst, const uint32_t *src, size_t count, uint32_t offset);
+
+// Returns false if an index does not fit 16 bits (dst is then partially written)
+bool narrow_indices(uint16_t *dst, const uint32_t *src, size_t count);
+void widen_indices(uint32_t *dst, const uint16_t *src, size_t count);
+
+// Packed arrays are handed to meshoptimizer in place. Vector2/Vector3 are tightly packed
+// real_t components, so in single-precision builds the array memory already is the float
+// stream meshoptimizer expects; double-precision builds narrow into a scratch buffer.
+template <typename T>
+const float *float_stream(const T *data, size_t count, std::vector<float> &scratch) {
+#ifdef REAL_T_IS_DOUBLE
+    const size_t component_count = count * (sizeof(T) / sizeof(real_t));
+    scratch.resize(component_count);
+    convert_floats(scratch.data(), reinterpret_cast<const real_t *>(data), component_count);
+    return scratch.data();
+#else
+    (void)count;
+    (void)scratch;
+    return reinterpret_cast<const float *>(data);
+#endif
+}
+
+// Inverse of float_stream(): write count elements of T from float components
+template <typename T>
+void store_float_stream(T *destination, const float *src, size_t count) {
+#ifdef REAL_T_IS_DOUBLE
+    const size_t component_count = count * (sizeof(T) / sizeof(real_t));
+    convert_floats(reinterpret_cast<real_t *>(destination), src, component_count);
+#else
+    memcpy(static_cast<void *>(destination), src, count * sizeof(T));
+#endif
+}
+
+// Byte stride of a float_stream() of T
+template <typename T>
+constexpr size_t float_stride() {
+    return (sizeof(T) / sizeof(real_t)) * sizeof(float);
+}
+
+inline const unsigned int *index_stream(const PackedInt32Array &indices) {
+    return reinterpret_cast<const unsigned int *>(indices.ptr());
+}
+
+inline unsigned int *index_stream_w(PackedInt32Array &indices) {
+    return reinterpret_cast<unsigned int *>(indices.ptrw());
+}
+
+} // namespace mesh_streams
+} // namespace godot
+
+#endif // MESHOPTIMIZER_STREAMS_H
@@ -0,0 +1,353 @@
+// MeshOptimizer GDExtension for Godot 4
+// Native Godot surface format (RenderingServer.mesh_add_surface) from mesh arrays
+
+#include "meshoptimizer_surface.h"
+#include "meshoptimizer_streams.h"
+
+#include <godot_cpp/classes/mesh.hpp>
+#include <godot_cpp/core/math.hpp>
+#include <godot_cpp/variant/aabb.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/packed_color_array.hpp>
+#include <godot_cpp/variant/packed_float32_array.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_vector2_array.hpp>
+#include <godot_cpp/variant/packed_vector3_array.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace godot;
+using namespace godot::mesh_streams;
+
+namespace {
+
+// Vector3::octahedron_encode, both components in [0, 1]
+void octahedron_encode(float x, float y, float z, float &r_u, float &r_v) {
+    float length = std::fabs(x) + std::fabs(y) + std::fabs(z);
+    if (length == 0.0f) {
+        // Degenerate vectors would encode NaN; +Z is as good as anything
+        r_u = 0.5f;
+        r_v = 0.5f;
+        return;
+    }
+    x /= length;
+    y /= length;
+    z /= length;
+
+    float u = x;
+    float v = y;
+    if (z < 0.0f) {
+        u = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        v = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+    }
+    r_u = u * 0.5f + 0.5f;
+    r_v = v * 0.5f + 0.5f;
+}
+
+// Vector3::octahedron_tangent_encode: the binormal sign selects the half of v
+void octahedron_tangent_encode(float x, float y, float z, float sign, float &r_u, float &r_v) {
+    octahedron_encode(x, y, z, r_u, r_v);
+    r_v = std::max(r_v, 1.0f / 32767.0f) * 0.5f + 0.5f;
+    if (sign < 0.0f) {
+        r_v = 1.0f - r_v;
+    }
+}
+
+void store_oct16(uint8_t *dst, float u, float v) {
+    uint16_t vector[2] = {
+        static_cast<uint16_t>(CLAMP(u * 65535.0f, 0.0f, 65535.0f)),
+        static_cast<uint16_t>(CLAMP(v * 65535.0f, 0.0f, 65535.0f)),
+    };
+    // (0, 1) and (1, 1) decode the same; RenderingServer sanitizes to the latter for its compression checks
+    if (vector[0] == 0 && vector[1] == 65535) {
+        vector[0] = 65535;
+    }
+    memcpy(dst, vector, sizeof(vector));
+}
+
+uint16_t unorm16(float value) {
+    return static_cast<uint16_t>(CLAMP(value * 65535.0f, 0.0f, 65535.0f));
+}
+
+// Index buffer in the RenderingServer index format; false if an index is out of range
+bool store_indices(const PackedInt32Array &indices, size_t vertex_count, bool use_16_bit, PackedByteArray &r_data) {
+    size_t index_count = indices.size();
+    const unsigned int *src = index_stream(indices);
+    for (size_t i = 0; i < index_count; i++) {
+        if (src[i] >= vertex_count) {
+            return false;
+        }
+    }
+
+    if (use_16_bit) {
+        r_data.resize(index_count * sizeof(uint16_t));
+        narrow_indices(reinterpret_cast<uint16_t *>(r_data.ptrw()), src, index_count);
+    } else {
+        r_data.resize(index_count * sizeof(uint32_t));
+        memcpy(r_data.ptrw(), src, index_count * sizeof(uint32_t));
+    }
+    return true;
+}
+
+// True if the array is there with the expected type and size; sets r_error if it is there but wrong
+bool check_array(const Array &mesh_arrays, int array_type, Variant::Type type, size_t expected_size, String &r_error) {
+    const Variant &value = mesh_arrays[array_type];
+    if (value.get_type() == Variant::NIL) {
+        return false;
+    }
+
+    size_t size = 0;
+    switch (value.get_type()) {
+        case Variant::PACKED_VECTOR3_ARRAY: size = PackedVector3Array(value).size(); break;
+        case Variant::PACKED_VECTOR2_ARRAY: size = PackedVector2Array(value).size(); break;
+        case Variant::PACKED_COLOR_ARRAY: size = PackedColorArray(value).size(); break;
+        case Variant::PACKED_FLOAT32_ARRAY: size = PackedFloat32Array(value).size(); break;
+        case Variant::PACKED_INT32_ARRAY: size = PackedInt32Array(value).size(); break;
+        default: break;
+    }
+    if (value.get_type() != type || size != expected_size) {
+        r_error = String("Array ") + String::num_int64(array_type) + " does not match the vertex count or type";
+    }
+    return r_error.is_empty();
+}
+
+} // namespace
+
+namespace godot {
+namespace mesh_surface {
+
+Dictionary build_surface_data(const Array &mesh_arrays, const Array &lods, int64_t primitive, String &r_error) {
+    Dictionary result;
+
+    if (mesh_arrays.size() < Mesh::ARRAY_MAX) {
+        r_error = "Invalid mesh arrays size";
+        return result;
+    }
+
+    Variant v_vertices = mesh_arrays[Mesh::ARRAY_VERTEX];
+    if (v_vertices.get_type() != Variant::PACKED_VECTOR3_ARRAY || PackedVector3Array(v_vertices).size() == 0) {
+        r_error = "Missing vertices (2D surfaces are not supported)";
+        return result;
+    }
+    const PackedVector3Array vertices = v_vertices;
+    size_t vertex_count = vertices.size();
+
+    for (int i = Mesh::ARRAY_CUSTOM0; i <= Mesh::ARRAY_CUSTOM3; i++) {
+        if (mesh_arrays[i].get_type() != Variant::NIL) {
+            r_error = "Custom arrays need add_surface_from_arrays";
+            return result;
+        }
+    }
+
+    bool has_normals = check_array(mesh_arrays, Mesh::ARRAY_NORMAL, Variant::PACKED_VECTOR3_ARRAY, vertex_count, r_error);
+    bool has_tangents = check_array(mesh_arrays, Mesh::ARRAY_TANGENT, Variant::PACKED_FLOAT32_ARRAY, vertex_count * 4, r_error);
+    bool has_colors = check_array(mesh_arrays, Mesh::ARRAY_COLOR, Variant::PACKED_COLOR_ARRAY, vertex_count, r_error);
+    bool has_uvs = check_array(mesh_arrays, Mesh::ARRAY_TEX_UV, Variant::PACKED_VECTOR2_ARRAY, vertex_count, r_error);
+    bool has_uv2s = check_array(mesh_arrays, Mesh::ARRAY_TEX_UV2, Variant::PACKED_VECTOR2_ARRAY, vertex_count, r_error);
+
+    // 4 or 8 influences, told apart by the bone array size
+    size_t bone_count = 0;
+    if (r_error.is_empty() && mesh_arrays[Mesh::ARRAY_BONES].get_type() == Variant::PACKED_INT32_ARRAY) {
+        bone_count = static_cast<size_t>(PackedInt32Array(mesh_arrays[Mesh::ARRAY_BONES]).size()) == vertex_count * 8 ? 8 : 4;
+    }
+    bool has_bones = check_array(mesh_arrays, Mesh::ARRAY_BONES, Variant::PACKED_INT32_ARRAY, vertex_count * bone_count, r_error);
+    bool has_weights = check_array(mesh_arrays, Mesh::ARRAY_WEIGHTS, Variant::PACKED_FLOAT32_ARRAY, vertex_count * bone_count, r_error);
+    if (r_error.is_empty() && has_bones != has_weights) {
+        r_error = "Bones and weights must be used together";
+    }
+    if (!r_error.is_empty()) {
+        return result;
+    }
+
+    uint64_t format = Mesh::ARRAY_FORMAT_VERTEX | FORMAT_VERSION_2;
+    if (has_normals) format |= Mesh::ARRAY_FORMAT_NORMAL;
+    if (has_tangents) format |= Mesh::ARRAY_FORMAT_TANGENT;
+    if (has_colors) format |= Mesh::ARRAY_FORMAT_COLOR;
+    if (has_uvs) format |= Mesh::ARRAY_FORMAT_TEX_UV;
+    if (has_uv2s) format |= Mesh::ARRAY_FORMAT_TEX_UV2;
+    if (has_bones) format |= Mesh::ARRAY_FORMAT_BONES | Mesh::ARRAY_FORMAT_WEIGHTS;
+    if (bone_count == 8) format |= Mesh::ARRAY_FLAG_USE_8_BONE_WEIGHTS;
+
+    // Vertex stream: all positions, then the interleaved normal/tangent stream
+    std::vector<float> position_scratch;
+    const float *positions = float_stream(vertices.ptr(), vertex_count, position_scratch);
+    size_t normal_stride = (has_normals ? 4 : 0) + (has_tangents ? 4 : 0);
+    size_t position_size = vertex_count * sizeof(float) * 3;
+
+    PackedByteArray vertex_data;
+    vertex_data.resize(position_size + vertex_count * normal_stride);
+    uint8_t *vw = vertex_data.ptrw();
+    memcpy(vw, positions, position_size);
+
+    if (has_normals) {
+        const PackedVector3Array normals = mesh_arrays[Mesh::ARRAY_NORMAL];
+        std::vector<float> scratch;
+        const float *src = float_stream(normals.ptr(), vertex_count, scratch);
+        for (size_t i = 0; i < vertex_count; i++) {
+            float u, v;
+            octahedron_encode(src[i * 3 + 0], src[i * 3 + 1], src[i * 3 + 2], u, v);
+            store_oct16(vw + position_size + i * normal_stride, u, v);
+        }
+    }
+    if (has_tangents) {
+        const PackedFloat32Array tangents = mesh_arrays[Mesh::ARRAY_TANGENT];
+        const float *src = tangents.ptr();
+        size_t offset = has_normals ? 4 : 0;
+        for (size_t i = 0; i < vertex_count; i++) {
+            float u, v;
+            octahedron_tangent_encode(src[i * 4 + 0], src[i * 4 + 1], src[i * 4 + 2], src[i * 4 + 3], u, v);
+            store_oct16(vw + position_size + i * normal_stride + offset, u, v);
+        }
+    }
+
+    // Attribute stream: color, uv, uv2
+    size_t attribute_stride = (has_colors ? 4 : 0) + (has_uvs ? 8 : 0) + (has_uv2s ? 8 : 0);
+    if (attribute_stride > 0) {
+        PackedByteArray attribute_data;
+        attribute_data.resize(vertex_count * attribute_stride);
+        uint8_t *aw = attribute_data.ptrw();
+        size_t offset = 0;
+
+        if (has_colors) {
+            const PackedColorArray colors = mesh_arrays[Mesh::ARRAY_COLOR];
+            for (size_t i = 0; i < vertex_count; i++) {
+                const Color &c = colors[i];
+                uint8_t *dst = aw + i * attribute_stride;
+                dst[0] = static_cast<uint8_t>(CLAMP(c.r * 255.0f, 0.0f, 255.0f));
+                dst[1] = static_cast<uint8_t>(CLAMP(c.g * 255.0f, 0.0f, 255.0f));
+                dst[2] = static_cast<uint8_t>(CLAMP(c.b * 255.0f, 0.0f, 255.0f));
+                dst[3] = static_cast<uint8_t>(CLAMP(c.a * 255.0f, 0.0f, 255.0f));
+            }
+            offset += 4;
+        }
+        for (int array_type : { int(Mesh::ARRAY_TEX_UV), int(Mesh::ARRAY_TEX_UV2) }) {
+            if (!(format & (uint64_t(1) << array_type))) {
+                continue;
+            }
+            const PackedVector2Array uvs = mesh_arrays[array_type];
+            std::vector<float> scratch;
+            const float *src = float_stream(uvs.ptr(), vertex_count, scratch);
+            for (size_t i = 0; i < vertex_count; i++) {
+                memcpy(aw + i * attribute_stride + offset, src + i * 2, sizeof(float) * 2);
+            }
+            offset += 8;
+        }
+        result["attribute_data"] = attribute_data;
+    }
+
+    // Skin stream: bones then weights, plus the per-bone bounds skeleton culling uses
+    if (has_bones) {
+        const PackedInt32Array bones = mesh_arrays[Mesh::ARRAY_BONES];
+        const PackedFloat32Array weights = mesh_arrays[Mesh::ARRAY_WEIGHTS];
+        size_t skin_stride = bone_count * sizeof(uint16_t) * 2;
+
+        PackedByteArray skin_data;
+        skin_data.resize(vertex_count * skin_stride);
+        uint8_t *sw = skin_data.ptrw();
+
+        std::vector<float> bone_bounds; // min xyz, max xyz per bone; min.x > max.x while unused
+        for (size_t i = 0; i < vertex_count; i++) {
+            uint16_t values[16];
+            for (size_t j = 0; j < bone_count; j++) {
+                int32_t bone = bones[i * bone_count + j];
+                float weight = weights[i * bone_count + j];
+                values[j] = static_cast<uint16_t>(CLAMP(bone, 0, 65535));
+                values[bone_count + j] = unorm16(weight);
+
+                if (weight < CMP_EPSILON || bone < 0) {
+                    continue;
+                }
+                if (bone_bounds.size() < (static_cast<size_t>(bone) + 1) * 6) {
+                    size_t old_size = bone_bounds.size();
+                    bone_bounds.resize((static_cast<size_t>(bone) + 1) * 6);
+                    for (size_t b = old_size; b < bone_bounds.size(); b += 6) {
+                        std::fill(bone_bounds.begin() + b, bone_bounds.begin() + b + 3, INFINITY);
+                        std::fill(bone_bounds.begin() + b + 3, bone_bounds.begin() + b + 6, -INFINITY);
+                    }
+                }
+                float *bounds = bone_bounds.data() + bone * 6;
+                for (int c = 0; c < 3; c++) {
+                    bounds[c] = std::min(bounds[c], positions[i * 3 + c]);
+                    bounds[c + 3] = std::max(bounds[c + 3], positions[i * 3 + c]);
+                }
+            }
+            memcpy(sw + i * skin_stride, values, skin_stride);
+        }
+
+        Array bone_aabbs;
+        for (size_t b = 0; b < bone_bounds.size(); b += 6) {
+            const float *bounds = bone_bounds.data() + b;
+            if (bounds[0] > bounds[3]) {
+                // What RenderingServer uses for bones no vertex is weighted to
+                bone_aabbs.push_back(AABB(Vector3(), Vector3(-1, -1, -1)));
+            } else {
+                bone_aabbs.push_back(AABB(Vector3(bounds[0], bounds[1], bounds[2]),
+                    Vector3(bounds[3] - bounds[0], bounds[4] - bounds[1], bounds[5] - bounds[2])));
+            }
+        }
+        result["skin_data"] = skin_data;
+        result["bone_aabbs"] = bone_aabbs;
+    }
+
+    // Indices, 16-bit whenever every vertex is addressable
+    bool use_16_bit = vertex_count <= 65536;
+    Variant v_indices = mesh_arrays[Mesh::ARRAY_INDEX];
+    if (v_indices.get_type() == Variant::PACKED_INT32_ARRAY && PackedInt32Array(v_indices).size() > 0) {
+        const PackedInt32Array indices = v_indices;
+        PackedByteArray index_data;
+        if (!store_indices(indices, vertex_count, use_16_bit, index_data)) {
+            r_error = "Index out of range";
+            return Dictionary();
+        }
+        format |= Mesh::ARRAY_FORMAT_INDEX;
+        result["index_data"] = index_data;
+        result["index_count"] = static_cast<int64_t>(indices.size());
+
+        Array surface_lods;
+        for (int64_t i = 0; i < lods.size(); i++) {
+            Dictionary lod = lods[i];
+            PackedInt32Array lod_indices = lod.get("indices", PackedInt32Array());
+            if (lod_indices.is_empty()) {
+                continue;
+            }
+
+            PackedByteArray lod_data;
+            if (!store_indices(lod_indices, vertex_count, use_16_bit, lod_data)) {
+                r_error = String("LOD ") + String::num_int64(i) + " index out of range";
+                return Dictionary();
+            }
+            Dictionary surface_lod;
+            surface_lod["edge_length"] = lod.get("world_error", 0.0f);
+            surface_lod["index_data"] = lod_data;
+            surface_lods.push_back(surface_lod);
+        }
+        if (!surface_lods.is_empty()) {
+            result["lods"] = surface_lods;
+        }
+    } else if (!lods.is_empty()) {
+        r_error = "LODs need an indexed surface";
+        return Dictionary();
+    }
+
+    float lo[3] = { positions[0], positions[1], positions[2] };
+    float hi[3] = { positions[0], positions[1], positions[2] };
+    for (size_t i = 1; i < vertex_count; i++) {
+        for (int c = 0; c < 3; c++) {
+            lo[c] = std::min(lo[c], positions[i * 3 + c]);
+            hi[c] = std::max(hi[c], positions[i * 3 + c]);
+        }
+    }
+
+    result["primitive"] = primitive;
+    result["format"] = static_cast<int64_t>(format);
+    result["vertex_data"] = vertex_data;
+    result["vertex_count"] = static_cast<int64_t>(vertex_count);
+    result["aabb"] = AABB(Vector3(lo[0], lo[1], lo[2]), Vector3(hi[0] - lo[0], hi[1] - lo[1], hi[2] - lo[2]));
+
+    return result;
+}
+
+} // namespace mesh_surface
+} // namespace godot
@@ -0,0 +1,32 @@
+// MeshOptimizer GDExtension for Godot 4
+// Native Godot surface format (RenderingServer.mesh_add_surface) from mesh arrays
+#ifndef MESHOPTIMIZER_SURFACE_H
+#define MESHOPTIMIZER_SURFACE_H
+
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/string.hpp>
+
+#include <cstdint>
+
+namespace godot {
+namespace mesh_surface {
+
+// RenderingServer::ARRAY_FLAG_FORMAT_VERSION_2, the layout below (Godot 4.2+)
+constexpr uint64_t FORMAT_VERSION_2 = uint64_t(1) << 35;
+
+// Build the surface Dictionary RenderingServer.mesh_add_surface takes, uncompressed:
+//   vertex_data: float32 xyz positions for every vertex, then normal/tangent pairs (octahedral
+//     unorm16 x2 each, the tangent's binormal sign folded into y)
+//   attribute_data: color (unorm8 x4), uv, uv2 (float32 x2) per vertex
+//   skin_data: bones (uint16 x4 or x8), weights (unorm16 x4 or x8) per vertex, plus bone_aabbs
+//   index_data/lods: uint16 indices up to 65536 vertices, else uint32
+// lods: Dictionaries with "indices" and "world_error" (as generate_lod_chain returns), used as edge_length
+// Returns an empty Dictionary and sets r_error for arrays the format cannot hold (custom, 2D)
+// Only reads its inputs, so it can run on worker threads
+Dictionary build_surface_data(const Array &mesh_arrays, const Array &lods, int64_t primitive, String &r_error);
+
+} // namespace mesh_surface
+} // namespace godot
+
+#endif // MESHOPTIMIZER_SURFACE_H
@@ -2,10 +2,15 @@
 
 #include "register_types.h"
 #include "meshoptimizer_gdext.h"
+#include "meshoptimizer_result.h"
+#include "meshoptimizer_batch.h"
+#include "meshoptimizer_mapped.h"
+#include "meshoptimizer_arena.h"
 
 #include <gdextension_interface.h>
 #include <godot_cpp/core/defs.hpp>
 #include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/variant/callable_method_pointer.hpp>
 #include <godot_cpp/godot.hpp>
 
 using namespace godot;
@@ -15,13 +20,24 @@ void initialize_meshoptimizer_module(ModuleInitializationLevel p_level) {
         return;
     }
 
+    mesh_arena::install();
+
+    ClassDB::register_class<MeshOptimizerResult>();
     ClassDB::register_class<MeshOptimizerGD>();
+    ClassDB::register_class<MeshOptimizerBatch>();
+    ClassDB::register_class<MeshOptimizerMappedFile>();
+
+    // Performance is created after extensions initialize, so its monitors go in on the first frame
+    callable_mp_static(&MeshOptimizerGD::register_performance_monitors).call_deferred();
 }
 
 void uninitialize_meshoptimizer_module(ModuleInitializationLevel p_level) {
     if (p_level != MODULE_INITIALIZATION_LEVEL_SCENE) {
         return;
     }
+
+    MeshOptimizerGD::unregister_performance_monitors();
+    mesh_arena::uninstall();
 }
 
 extern "C" {
@@ -0,0 +1,300 @@
+extends SceneTree
+
+## Headless throughput benchmark for the MeshOptimizerGD extension:
+## godot --headless --script res://benchmark_meshoptimizer.gd -- [--corpus=DIR] [--out=FILE] [--iterations=N]
+##
+## The corpus is a directory of exported mesh resources (.tres/.res/.mesh, e.g. converted NIF
+## surfaces and merged cells), searched recursively. Without one, procedural grids are used so the
+## numbers are still comparable between builds. Results are printed and written as JSON.
+##
+## Per entry point: calls, triangles, wall time, tris/sec and, for the *_into variants, the split
+## between kernel time (inside meshoptimizer) and marshalling (everything else in the call).
+
+const DEFAULT_CORPUS := "res://benchmarks/meshoptimizer_corpus/"
+const DEFAULT_OUTPUT := "user://meshoptimizer_benchmark.json"
+const DEFAULT_ITERATIONS := 5
+const MESH_EXTENSIONS: Array[String] = ["tres", "res", "mesh"]
+const CELL_SIZE := 16 # Surfaces per synthetic merged cell
+
+var _optimizer: MeshOptimizerGD
+var _result: MeshOptimizerResult
+var _entries: Dictionary = {}
+
+
+func _init() -> void:
+	print("============================================================")
+	print("MeshOptimizerGD Benchmark (Headless)")
+	print("============================================================")
+
+	if not ClassDB.class_exists("MeshOptimizerGD"):
+		push_error("MeshOptimizerGD is not loaded, build the meshoptimizer extension first")
+		quit(1)
+		return
+
+	var args := _parse_args()
+	var corpus_path: String = args.get("corpus", DEFAULT_CORPUS)
+	var output_path: String = args.get("out", DEFAULT_OUTPUT)
+	var iterations: int = maxi(int(args.get("iterations", DEFAULT_ITERATIONS)), 1)
+
+	_optimizer = MeshOptimizerGD.new()
+	_result = MeshOptimizerResult.new()
+
+	var surfaces := _load_corpus(corpus_path)
+	var corpus_name := corpus_path
+	if surfaces.is_empty():
+		print("No corpus at %s, using procedural grids" % corpus_path)
+		surfaces = _procedural_corpus()
+		corpus_name = "procedural"
+
+	var total_triangles := 0
+	for arrays: Array in surfaces:
+		total_triangles += _triangle_count(arrays)
+	print("Corpus: %d surfaces, %d triangles, %d iterations" % [surfaces.size(), total_triangles, iterations])
+
+	MeshOptimizerGD.reset_allocator_stats()
+	var start_time := Time.get_ticks_msec()
+
+	for i in range(iterations):
+		for arrays: Array in surfaces:
+			_bench_surface(arrays)
+		_bench_merge(surfaces)
+	_bench_batch(surfaces, iterations)
+
+	var elapsed := (Time.get_ticks_msec() - start_time) / 1000.0
+
+	var report := {
+		"version": _optimizer.get_version(),
+		"corpus": corpus_name,
+		"surfaces": surfaces.size(),
+		"triangles": total_triangles,
+		"iterations": iterations,
+		"elapsed_sec": elapsed,
+		"peak_rss_bytes": MeshOptimizerGD.get_peak_memory_usage(),
+		"allocator": MeshOptimizerGD.get_allocator_stats(),
+		"entries": _finish_entries(),
+	}
+
+	_print_report(report)
+
+	var file := FileAccess.open(output_path, FileAccess.WRITE)
+	if file == null:
+		push_error("Cannot write %s: %s" % [output_path, error_string(FileAccess.get_open_error())])
+		quit(1)
+		return
+	file.store_string(JSON.stringify(report, "\t"))
+	file.close()
+
+	print("\nReport written to %s (%.1f seconds)" % [ProjectSettings.globalize_path(output_path), elapsed])
+	quit(0)
+
+
+func _parse_args() -> Dictionary:
+	var args := {}
+	for arg: String in OS.get_cmdline_user_args():
+		if arg.begins_with("--") and arg.contains("="):
+			var split := arg.substr(2).split("=", true, 1)
+			args[split[0]] = split[1]
+	return args
+
+
+# --- Corpus ---
+
+func _load_corpus(path: String) -> Array[Array]:
+	var surfaces: Array[Array] = []
+	var files: Array[String] = []
+	_collect_files(path, files)
+	files.sort()
+
+	for file_path: String in files:
+		var mesh := load(file_path) as Mesh
+		if mesh == null:
+			continue
+		for s in range(mesh.get_surface_count()):
+			var arrays := mesh.surface_get_arrays(s)
+			if _triangle_count(arrays) > 0:
+				surfaces.append(arrays)
+	return surfaces
+
+
+func _collect_files(path: String, files: Array[String]) -> void:
+	var dir := DirAccess.open(path)
+	if dir == null:
+		return
+	for sub: String in dir.get_directories():
+		_collect_files(path.path_join(sub), files)
+	for file_name: String in dir.get_files():
+		if file_name.get_extension().to_lower() in MESH_EXTENSIONS:
+			files.append(path.path_join(file_name))
+
+
+func _procedural_corpus() -> Array[Array]:
+	var surfaces: Array[Array] = []
+	for size: int in [8, 16, 32, 64, 128]:
+		for i in range(4):
+			surfaces.append(_make_grid(size, float(i)))
+	return surfaces
+
+
+# Wavy grid with UVs and normals, roughly the density of Morrowind statics
+func _make_grid(size: int, seed_offset: float) -> Array:
+	var vertices := PackedVector3Array()
+	var normals := PackedVector3Array()
+	var uvs := PackedVector2Array()
+	var indices := PackedInt32Array()
+
+	for z in range(size + 1):
+		for x in range(size + 1):
+			var height := sin(x * 0.3 + seed_offset) * cos(z * 0.2) * 2.0
+			vertices.append(Vector3(x, height, z))
+			normals.append(Vector3.UP)
+			uvs.append(Vector2(float(x) / size, float(z) / size))
+
+	for z in range(size):
+		for x in range(size):
+			var i := z * (size + 1) + x
+			indices.append_array(PackedInt32Array([i, i + 1, i + size + 1, i + 1, i + size + 2, i + size + 1]))
+
+	var arrays := []
+	arrays.resize(Mesh.ARRAY_MAX)
+	arrays[Mesh.ARRAY_VERTEX] = vertices
+	arrays[Mesh.ARRAY_NORMAL] = normals
+	arrays[Mesh.ARRAY_TEX_UV] = uvs
+	arrays[Mesh.ARRAY_INDEX] = indices
+	return arrays
+
+
+func _triangle_count(arrays: Array) -> int:
+	if arrays.size() <= Mesh.ARRAY_INDEX:
+		return 0
+	var indices = arrays[Mesh.ARRAY_INDEX]
+	if indices is PackedInt32Array and not indices.is_empty():
+		return indices.size() / 3
+	var vertices = arrays[Mesh.ARRAY_VERTEX]
+	return vertices.size() / 3 if vertices is PackedVector3Array else 0
+
+
+# --- Entry points ---
+
+func _bench_surface(arrays: Array) -> void:
+	var vertices: PackedVector3Array = arrays[Mesh.ARRAY_VERTEX]
+	var indices = arrays[Mesh.ARRAY_INDEX]
+	if not indices is PackedInt32Array or indices.is_empty():
+		return
+	var uvs = arrays[Mesh.ARRAY_TEX_UV]
+	if not uvs is PackedVector2Array:
+		uvs = PackedVector2Array()
+	var triangles: int = indices.size() / 3
+
+	var start := Time.get_ticks_usec()
+	_optimizer.simplify_into(vertices, indices, 0.5, 0.01, false, _result)
+	_record("simplify_into", triangles, Time.get_ticks_usec() - start, _result.get_kernel_usec())
+
+	start = Time.get_ticks_usec()
+	_optimizer.simplify(vertices, indices, 0.5, 0.01, false)
+	_record("simplify", triangles, Time.get_ticks_usec() - start)
+
+	start = Time.get_ticks_usec()
+	_optimizer.simplify_sloppy_into(vertices, indices, 0.5, 0.01, false, _result)
+	_record("simplify_sloppy_into", triangles, Time.get_ticks_usec() - start, _result.get_kernel_usec())
+
+	start = Time.get_ticks_usec()
+	_optimizer.simplify_with_attributes_into(vertices, indices, uvs, 0.5, 0.01, 1.0, false, PackedByteArray(), 0, _result)
+	_record("simplify_with_attributes_into", triangles, Time.get_ticks_usec() - start, _result.get_kernel_usec())
+
+	start = Time.get_ticks_usec()
+	_optimizer.weld_vertices_into(vertices, indices, 0.0001, _result)
+	_record("weld_vertices_into", triangles, Time.get_ticks_usec() - start, _result.get_kernel_usec())
+
+	start = Time.get_ticks_usec()
+	_optimizer.optimize_vertex_cache(indices, vertices.size())
+	_record("optimize_vertex_cache", triangles, Time.get_ticks_usec() - start)
+
+	start = Time.get_ticks_usec()
+	_optimizer.simplify_mesh_arrays(arrays, 0.5)
+	_record("simplify_mesh_arrays", triangles, Time.get_ticks_usec() - start)
+
+	start = Time.get_ticks_usec()
+	_optimizer.optimize_surface(arrays)
+	_record("optimize_surface", triangles, Time.get_ticks_usec() - start)
+
+
+# Merge the corpus in fixed-size groups, standing in for prebaked cells
+func _bench_merge(surfaces: Array[Array]) -> void:
+	for first in range(0, surfaces.size(), CELL_SIZE):
+		var cell := surfaces.slice(first, first + CELL_SIZE)
+		var triangles := 0
+		for arrays: Array in cell:
+			triangles += _triangle_count(arrays)
+
+		var start := Time.get_ticks_usec()
+		_optimizer.merge_surfaces(cell, [], {"target_ratio": 0.5})
+		_record("merge_surfaces", triangles, Time.get_ticks_usec() - start)
+
+
+# Every surface as one simplify job on the worker pool, timed to completion
+func _bench_batch(surfaces: Array[Array], iterations: int) -> void:
+	var batch := MeshOptimizerBatch.new()
+	var triangles := 0
+
+	var start := Time.get_ticks_usec()
+	for i in range(iterations):
+		for arrays: Array in surfaces:
+			batch.queue_simplify(arrays, 0.5)
+			triangles += _triangle_count(arrays)
+	batch.wait()
+	var elapsed := Time.get_ticks_usec() - start
+
+	# Kernel time here is the summed per-job worker time, so it can exceed the wall time
+	var worker_usec := 0
+	for job: Dictionary in batch.poll_results():
+		worker_usec += int(job.get("time_usec", 0))
+	_record("batch_simplify", triangles, elapsed, worker_usec)
+	_entries["batch_simplify"]["threads"] = batch.get_thread_count()
+
+
+# --- Reporting ---
+
+func _record(entry_name: String, triangles: int, wall_usec: int, kernel_usec: int = -1) -> void:
+	if not _entries.has(entry_name):
+		_entries[entry_name] = {"calls": 0, "triangles": 0, "wall_usec": 0, "kernel_usec": 0, "timed_kernel": kernel_usec >= 0}
+	var entry: Dictionary = _entries[entry_name]
+	entry["calls"] += 1
+	entry["triangles"] += triangles
+	entry["wall_usec"] += wall_usec
+	if kernel_usec >= 0:
+		entry["kernel_usec"] += kernel_usec
+
+
+func _finish_entries() -> Dictionary:
+	var report := {}
+	for entry_name: String in _entries:
+		var entry: Dictionary = _entries[entry_name]
+		var wall: int = entry["wall_usec"]
+		var out := {
+			"calls": entry["calls"],
+			"triangles": entry["triangles"],
+			"wall_usec": wall,
+			"tris_per_sec": entry["triangles"] * 1000000.0 / wall if wall > 0 else 0.0,
+		}
+		if entry["timed_kernel"]:
+			var kernel: int = entry["kernel_usec"]
+			out["kernel_usec"] = kernel
+			out["marshal_usec"] = maxi(wall - kernel, 0)
+			out["kernel_fraction"] = float(kernel) / wall if wall > 0 else 0.0
+		if entry.has("threads"):
+			out["threads"] = entry["threads"]
+		report[entry_name] = out
+	return report
+
+
+func _print_report(report: Dictionary) -> void:
+	print("\n%-32s %8s %12s %14s %10s" % ["entry", "calls", "wall ms", "Mtris/sec", "kernel %"])
+	var entries: Dictionary = report["entries"]
+	for entry_name: String in entries:
+		var entry: Dictionary = entries[entry_name]
+		var kernel := "-"
+		if entry.has("kernel_fraction"):
+			kernel = "%.1f" % (entry["kernel_fraction"] * 100.0)
+		print("%-32s %8d %12.2f %14.3f %10s" % [
+			entry_name, entry["calls"], entry["wall_usec"] / 1000.0, entry["tris_per_sec"] / 1000000.0, kernel])
+	print("\nPeak RSS: %.1f MB" % (report["peak_rss_bytes"] / 1048576.0))
@@ -0,0 +1,177 @@
+extends SceneTree
+
+## Headless reentrancy stress test for the static MeshOptimizerGD API:
+## godot --headless --script res://stress_meshoptimizer.gd -- [--rounds=N] [--tasks=N]
+##
+## Every entry point is first run once per surface on the main thread for a reference result.
+## Each round then runs N WorkerThreadPool tasks at once, all calling the static methods on the
+## same shared inputs without an instance or a lock, and every result must match its reference.
+## The last round repeats this with the result cache enabled, so its lock is contended as well.
+## Exits with 1 on the first round that produced a mismatch.
+
+const DEFAULT_ROUNDS := 4
+const DEFAULT_TASKS := 256
+const CACHE_BYTES := 64 * 1024 * 1024
+
+const OPERATIONS: Array[String] = [
+	"simplify_into",
+	"simplify_mesh_arrays",
+	"generate_lod_chain",
+	"generate_lod_chain_by_error",
+	"optimize_surface",
+	"weld_vertices",
+	"build_meshlets",
+	"build_view_orders",
+	"build_collision_proxy",
+	"encode_decode",
+	"analyze_surface",
+	"merge_surfaces",
+]
+
+var _surfaces: Array[Array] = []
+var _references: Array = []
+var _mutex := Mutex.new()
+var _mismatches: Array[String] = []
+
+
+func _init() -> void:
+	print("============================================================")
+	print("MeshOptimizerGD Reentrancy Stress Test (Headless)")
+	print("============================================================")
+
+	if not ClassDB.class_exists("MeshOptimizerGD"):
+		push_error("MeshOptimizerGD is not loaded, build the meshoptimizer extension first")
+		quit(1)
+		return
+
+	var args := _parse_args()
+	var rounds: int = maxi(int(args.get("rounds", DEFAULT_ROUNDS)), 1)
+	var tasks: int = maxi(int(args.get("tasks", DEFAULT_TASKS)), 1)
+
+	for size: int in [8, 24, 48]:
+		for i in range(2):
+			_surfaces.append(_make_grid(size, float(i)))
+
+	for surface_index in range(_surfaces.size()):
+		var row := []
+		for operation: String in OPERATIONS:
+			row.append(_run(operation, surface_index))
+		_references.append(row)
+	print("References: %d surfaces x %d entry points" % [_surfaces.size(), OPERATIONS.size()])
+
+	MeshOptimizerGD.reset_stats()
+	var start_time := Time.get_ticks_msec()
+
+	for round_index in range(rounds):
+		var cached := round_index == rounds - 1
+		if cached:
+			MeshOptimizerGD.configure_cache(CACHE_BYTES)
+
+		var round_start := Time.get_ticks_usec()
+		var group := WorkerThreadPool.add_group_task(_task, tasks, -1, true, "MeshOptimizerGD stress")
+		WorkerThreadPool.wait_for_group_task_completion(group)
+		var round_msec := (Time.get_ticks_usec() - round_start) / 1000.0
+
+		if cached:
+			MeshOptimizerGD.configure_cache(0)
+			MeshOptimizerGD.clear_cache()
+
+		print("Round %d%s: %d tasks in %.1f ms, %d mismatches" % [
+			round_index + 1, " (cached)" if cached else "", tasks, round_msec, _mismatches.size()])
+		if not _mismatches.is_empty():
+			for mismatch: String in _mismatches:
+				push_error(mismatch)
+			quit(1)
+			return
+
+	var stats := MeshOptimizerGD.get_stats()
+	print("\nPASS: %d calls on %d threads in %.1f seconds" % [
+		stats["calls"], stats["threads"], (Time.get_ticks_msec() - start_time) / 1000.0])
+	quit(0)
+
+
+func _parse_args() -> Dictionary:
+	var args := {}
+	for arg: String in OS.get_cmdline_user_args():
+		if arg.begins_with("--") and arg.contains("="):
+			var split := arg.substr(2).split("=", true, 1)
+			args[split[0]] = split[1]
+	return args
+
+
+# Spread the tasks so neighbouring ones hit different entry points on the same surface
+func _task(task_index: int) -> void:
+	var operation_index := task_index % OPERATIONS.size()
+	var surface_index := (task_index / OPERATIONS.size()) % _surfaces.size()
+	var result = _run(OPERATIONS[operation_index], surface_index)
+	if result != _references[surface_index][operation_index]:
+		_mutex.lock()
+		_mismatches.append("Task %d: %s on surface %d differs from its reference" % [
+			task_index, OPERATIONS[operation_index], surface_index])
+		_mutex.unlock()
+
+
+# Only static calls; the inputs are shared by every task and never written
+func _run(operation: String, surface_index: int) -> Variant:
+	var arrays := _surfaces[surface_index]
+	var vertices: PackedVector3Array = arrays[Mesh.ARRAY_VERTEX]
+	var indices: PackedInt32Array = arrays[Mesh.ARRAY_INDEX]
+
+	match operation:
+		"simplify_into":
+			# A result object per call, never shared between threads
+			var result := MeshOptimizerResult.new()
+			MeshOptimizerGD.simplify_into(vertices, indices, 0.5, 0.01, true, result)
+			return [result.get_vertices(), result.get_indices(), result.get_remap(), result.get_result_error()]
+		"simplify_mesh_arrays":
+			return MeshOptimizerGD.simplify_mesh_arrays(arrays, 0.25)
+		"generate_lod_chain":
+			return MeshOptimizerGD.generate_lod_chain(arrays, PackedFloat32Array([0.5, 0.25, 0.1]))
+		"generate_lod_chain_by_error":
+			return MeshOptimizerGD.generate_lod_chain_by_error(arrays, PackedFloat32Array([0.05, 0.2]))
+		"optimize_surface":
+			return MeshOptimizerGD.optimize_surface(arrays)
+		"weld_vertices":
+			return MeshOptimizerGD.weld_vertices(vertices, indices)
+		"build_meshlets":
+			return MeshOptimizerGD.build_meshlets(arrays)
+		"build_view_orders":
+			return MeshOptimizerGD.build_view_orders(arrays)
+		"build_collision_proxy":
+			return MeshOptimizerGD.build_collision_proxy(arrays, 64)
+		"encode_decode":
+			return MeshOptimizerGD.decode_surface(MeshOptimizerGD.encode_surface(arrays))
+		"analyze_surface":
+			return MeshOptimizerGD.analyze_surface(arrays)
+		"merge_surfaces":
+			var other := _surfaces[(surface_index + 1) % _surfaces.size()]
+			return MeshOptimizerGD.merge_surfaces([arrays, other], [Transform3D(), Transform3D(Basis(), Vector3(64, 0, 0))], {"target_ratio": 0.5})
+	return null
+
+
+# Wavy grid with UVs and normals, as in benchmark_meshoptimizer.gd
+func _make_grid(size: int, seed_offset: float) -> Array:
+	var vertices := PackedVector3Array()
+	var normals := PackedVector3Array()
+	var uvs := PackedVector2Array()
+	var indices := PackedInt32Array()
+
+	for z in range(size + 1):
+		for x in range(size + 1):
+			var height := sin(x * 0.3 + seed_offset) * cos(z * 0.2) * 2.0
+			vertices.append(Vector3(x, height, z))
+			normals.append(Vector3.UP)
+			uvs.append(Vector2(float(x) / size, float(z) / size))
+
+	for z in range(size):
+		for x in range(size):
+			var i := z * (size + 1) + x
+			indices.append_array(PackedInt32Array([i, i + 1, i + size + 1, i + 1, i + size + 2, i + size + 1]))
+
+	var arrays := []
+	arrays.resize(Mesh.ARRAY_MAX)
+	arrays[Mesh.ARRAY_VERTEX] = vertices
+	arrays[Mesh.ARRAY_NORMAL] = normals
+	arrays[Mesh.ARRAY_TEX_UV] = uvs
+	arrays[Mesh.ARRAY_INDEX] = indices
+	return arrays
@@ -0,0 +1,82 @@
+## Malformed-input tests for the MeshOptimizerGD surface container decoder
+##
+## Run with: godot --headless --script "res://test_meshoptimizer_codec.gd"
+##
+## Each case patches the first stream record of a valid encode_surface blob into a layout the
+## encoder never writes; decode_surface must reject it (empty Array, an error is pushed)
+## instead of handing it to a meshopt decoder. Exits with 1 if any case is accepted.
+extends SceneTree
+
+# Container header (8) + one surface entry (8) + surface header (16)
+const FIRST_RECORD := 32
+
+enum { KIND_VECTOR3, KIND_VECTOR2, KIND_COLOR, KIND_FLOAT32, KIND_INT32, KIND_BYTE }
+enum { FILTER_NONE, FILTER_OCT, FILTER_EXP }
+enum { ENCODING_RAW, ENCODING_VERTEX_CODEC }
+
+const MALFORMED_RECORDS := [
+	# [description, kind, filter, encoding, per_vertex, vertex_size]
+	["vertex codec over 256 bytes", KIND_BYTE, FILTER_NONE, ENCODING_VERTEX_CODEC, 1000, 1000],
+	["vertex codec, size not a multiple of 4", KIND_BYTE, FILTER_NONE, ENCODING_VERTEX_CODEC, 6, 6],
+	["octahedral filter on 100 floats", KIND_FLOAT32, FILTER_OCT, ENCODING_VERTEX_CODEC, 100, 4],
+	["octahedral filter on colors", KIND_COLOR, FILTER_OCT, ENCODING_VERTEX_CODEC, 1, 8],
+	["exp filter on integers", KIND_INT32, FILTER_EXP, ENCODING_VERTEX_CODEC, 3, 12],
+	["exp filter over 256 bytes", KIND_FLOAT32, FILTER_EXP, ENCODING_RAW, 100, 400],
+	["unknown filter", KIND_VECTOR3, 3, ENCODING_VERTEX_CODEC, 1, 12],
+	["unknown encoding", KIND_VECTOR3, FILTER_NONE, 2, 1, 12],
+]
+
+
+func _init() -> void:
+	print("=" .repeat(60))
+	print("MeshOptimizerGD Codec Test")
+	print("=" .repeat(60))
+
+	if not ClassDB.class_exists("MeshOptimizerGD"):
+		push_error("MeshOptimizerGD is not loaded, build the meshoptimizer extension first")
+		quit(1)
+		return
+
+	var blob := MeshOptimizerGD.encode_surface(_make_grid(8))
+	var failures := 0
+
+	if MeshOptimizerGD.decode_surface(blob).size() != Mesh.ARRAY_MAX:
+		print("FAIL: valid blob does not decode")
+		failures += 1
+	else:
+		print("PASS: valid blob decodes")
+
+	for case: Array in MALFORMED_RECORDS:
+		var patched := blob.duplicate()
+		patched.encode_u8(FIRST_RECORD + 1, case[1])
+		patched.encode_u8(FIRST_RECORD + 2, case[2])
+		patched.encode_u8(FIRST_RECORD + 3, case[3])
+		patched.encode_u16(FIRST_RECORD + 4, case[4])
+		patched.encode_u16(FIRST_RECORD + 6, case[5])
+		if MeshOptimizerGD.decode_surface(patched).is_empty():
+			print("PASS: rejected %s" % case[0])
+		else:
+			print("FAIL: accepted %s" % case[0])
+			failures += 1
+
+	print("\n" + "=" .repeat(60))
+	print("%d failures" % failures)
+	quit(1 if failures > 0 else 0)
+
+
+func _make_grid(size: int) -> Array:
+	var vertices := PackedVector3Array()
+	var indices := PackedInt32Array()
+	for z in range(size + 1):
+		for x in range(size + 1):
+			vertices.append(Vector3(x, 0, z))
+	for z in range(size):
+		for x in range(size):
+			var i := z * (size + 1) + x
+			indices.append_array(PackedInt32Array([i, i + 1, i + size + 1, i + 1, i + size + 2, i + size + 1]))
+
+	var arrays := []
+	arrays.resize(Mesh.ARRAY_MAX)
+	arrays[Mesh.ARRAY_VERTEX] = vertices
+	arrays[Mesh.ARRAY_INDEX] = indices
+	return arrays